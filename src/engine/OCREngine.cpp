@@ -4,40 +4,132 @@
 
 #include "OCREngine.h"
 #include <DOcr>
-#include <QProcess>
+#include <QStandardPaths>
 #include <QFileInfo>
+#include <QDateTime>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <QTransform>
+#include <QPainter>
+#include <QElapsedTimer>
+#include <QFutureInterface>
 #include <QDebug>
 #include <dconfigmanager.h>
+#include "ocrjob.h"
+#include "resultcache.h"
+#include "diskresultcache.h"
+#include "imagehash.h"
+#include "tilelayout.h"
+#include "functionrunnable.h"
+#include "imagepreprocess.h"
+#include "imageingest.h"
+#include "scriptdetector.h"
+#include "framehistory.h"
+#include "utils/systeminfo.h"
+#include "utils/hardwareprobe.h"
 #include "util/log.h"
 
+#include <algorithm>
+
+// 单个引擎实例(模型+推理缓存)的内存占用估计值
+static constexpr qint64 kEngineMemoryEstimate = 300LL * 1024 * 1024;
+// 自动计算时引擎池的上限
+static constexpr int kMaxAutoPoolSize = 4;
+// 自动计算引擎池大小时，每个实例预留的推理线程数
+static constexpr int kThreadsPerEngine = 2;
+
+// 默认的识别结果缓存大小(MB)
+static constexpr int kDefaultResultCacheSize = 16;
+// 默认的持久化结果缓存文件大小(MB)
+static constexpr int kDefaultDiskCacheSize = 64;
+// 默认的分块边长和重叠宽度(像素)，图片长边超过分块边长时分块识别
+static constexpr int kDefaultTileSize = 4096;
+static constexpr int kDefaultTileOverlap = 256;
+// 默认的目标文字行高(像素)
+static constexpr int kDefaultTargetTextHeight = 32;
+// 批量识别时解码线程数，以及识别线程之外额外预先解码的图片数
+static constexpr int kBatchDecodeThreads = 2;
+static constexpr int kBatchPrefetch = 2;
+// 画面去重保留的最近画面个数
+static constexpr int kFrameHistorySize = 4;
+// 流式识别时水平条带的高度和重叠高度(像素)，约为目标行高下20行文字
+static constexpr int kStreamBandHeight = 768;
+static constexpr int kStreamBandOverlap = 96;
+// 流式识别结果的缓存键后缀
+static const QString kStreamVariant = "stream";
+
+static const QString kPluginV5 = "PPOCR_V5";
+static const QString kPluginDefault = "default";
+// 路径中包含该字符串的共享库为OCR库及其插件(dtkocr、dtk6ocr及插件目录)
+static const QString kOcrLibraryMarker = "ocr";
+// 文件名包含该字符串的共享库为推理库
+static const QString kInferenceLibraryMarker = "ncnn";
+
+namespace {
+QMutex s_warmUpMutex;
+bool s_warmUpStarted = false;
+QFutureInterface<void> s_readiness;
+}
+
 OCREngine *OCREngine::instance()
 {
-    static OCREngine *ocr_detail = nullptr;
-    if (ocr_detail == nullptr) {
-        ocr_detail = new OCREngine;
-    }
+    //局部静态变量的初始化是线程安全的，并发调用会等待构造完成
+    static OCREngine *ocr_detail = new OCREngine;
     return ocr_detail;
 }
 
-OCREngine::OCREngine()
+QFuture<void> OCREngine::startWarmUp()
+{
+    QMutexLocker locker(&s_warmUpMutex);
+    if (s_warmUpStarted) {
+        return s_readiness.future();
+    }
+    s_warmUpStarted = true;
+    s_readiness.reportStarted();
+
+    QThreadPool::globalInstance()->start(new FunctionRunnable([]() {
+        QElapsedTimer timer;
+        timer.start();
+        OCREngine *engine = instance();
+        const qint64 constructMs = timer.restart();
+        engine->warmUpInference();
+        const qint64 inferenceMs = timer.elapsed();
+        qCInfo(dmOcr) << "Startup phase: engine construction" << constructMs << "ms, warm-up inference" << inferenceMs << "ms";
+        s_readiness.reportFinished();
+    }));
+    return s_readiness.future();
+}
+
+QFuture<void> OCREngine::readiness()
+{
+    QMutexLocker locker(&s_warmUpMutex);
+    //默认构造的future处于已完成状态
+    return s_warmUpStarted ? s_readiness.future() : QFuture<void>();
+}
+
+int OCREngine::maxPoolSize()
 {
-    //初始化变量
-    m_isRunning = false;
+    static const int size = calculatePoolSize();
+    return size;
+}
 
+OCREngine::OCREngine()
+{
     //初始化插件管理库
     //此处存在产品设计缺陷: 无法选择插件，无鉴权入口，无性能方面的高级设置入口
     //因此此处直接硬编码使用默认插件
     qCInfo(dmOcr) << "Initializing OCR driver";
 
-    ocrDriver = new Dtk::Ocr::DOcr;
-    const QString ocrV5 = "PPOCR_V5";
+    //第一个实例用于确定插件，后续实例按相同配置创建
+    auto ocrDriver = new Dtk::Ocr::DOcr;
     bool load = false;
 
     auto plugins = ocrDriver->installedPluginNames();
-    if (plugins.contains(ocrV5, Qt::CaseInsensitive)) {
-        if (ocrDriver->loadPlugin(ocrV5)) {
+    if (plugins.contains(kPluginV5, Qt::CaseInsensitive)) {
+        if (ocrDriver->loadPlugin(kPluginV5)) {
             load = true;
             m_isV5 = true;
+            m_pluginName = kPluginV5;
             qCInfo(dmOcr) << "OCR V5 plugin loaded";
         } else {
             qCWarning(dmOcr) << "Failed to load OCR V5 plugin";
@@ -46,60 +138,903 @@ OCREngine::OCREngine()
 
     if(!load) {
         ocrDriver->loadDefaultPlugin();
+        m_pluginName = kPluginDefault;
         qCInfo(dmOcr) << "Default OCR plugin loaded";
     }
- 
-    ocrDriver->setUseMaxThreadsCount(2);
-    if (!isGpuEnable()) {
+
+    if (isGpuEnable()) {
+        //KX-7000机型只在存在摩尔线程显卡时启用，其他机型保持原有规则直接启用
+        const HardwareInfo &hardware = HardwareProbe::info();
+        bool isKx7000 = hardware.cpuModel.contains("KX-7000");
+        m_useVulkan = hardware.hasMtGpu() || !isKx7000;
+        if (!m_useVulkan) {
+            qCInfo(dmOcr) << "No usable GPU device found, using CPU inference";
+        }
+    } else {
         qWarning() << "GPU is not enabled";
-        return;
     }
 
-    QProcess kxProc;
-    kxProc.setProgram("bash");
-    kxProc.setArguments({"-c", "lscpu | grep name"});
-    kxProc.start();
-    kxProc.waitForFinished();
-    QString cpuInfo = kxProc.readAllStandardOutput();
-    QFileInfo mtfi("/dev/mtgpu.0");
-    if (mtfi.exists() | !cpuInfo.contains("KX-7000")) {
+    if (m_useVulkan) {
         qCInfo(dmOcr) << "GPU device found, enabling Vulkan hardware acceleration";
         ocrDriver->setUseHardware({{Dtk::Ocr::HardwareID::GPU_Vulkan, 0}});
     }
-    qCInfo(dmOcr) << "OCR driver initialization completed";
+
+    int cacheSize = DConfigManager::instance()->value(COMMON_GROUP, COMMON_RESULTCACHESIZE, kDefaultResultCacheSize).toInt();
+    m_resultCache = new ResultCache(static_cast<qint64>(cacheSize) * 1024 * 1024);
+    int diskCacheSize = DConfigManager::instance()->value(COMMON_GROUP, COMMON_DISKCACHESIZE, kDefaultDiskCacheSize).toInt();
+    m_diskCache = new DiskResultCache(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/results.cache",
+                                      static_cast<qint64>(diskCacheSize) * 1024 * 1024,
+                                      modelIdentity());
+
+    m_tileSize = DConfigManager::instance()->value(COMMON_GROUP, COMMON_TILESIZE, kDefaultTileSize).toInt();
+    m_tileOverlap = DConfigManager::instance()->value(COMMON_GROUP, COMMON_TILEOVERLAP, kDefaultTileOverlap).toInt();
+    m_targetTextHeight = DConfigManager::instance()->value(COMMON_GROUP, COMMON_TARGETTEXTHEIGHT, kDefaultTargetTextHeight).toInt();
+    m_autoOrientation = DConfigManager::instance()->value(COMMON_GROUP, COMMON_AUTOORIENTATION, false).toBool();
+    if (DConfigManager::instance()->value(COMMON_GROUP, COMMON_FRAMEDEDUPLICATION, false).toBool()) {
+        m_frameHistory = new FrameHistory(kFrameHistorySize);
+    }
+
+    m_maxPoolSize = maxPoolSize();
+    m_driverLimit = calculateDriverLimit(m_maxPoolSize);
+    //分块任务各自借出引擎实例，线程数与引擎池上限一致
+    m_tilePool = new QThreadPool;
+    m_tilePool->setMaxThreadCount(m_maxPoolSize);
+    m_inferenceCpus = inferenceCpuCount();
+    m_threadCount = calculateThreadCount();
+    m_drivers.append(ocrDriver);
+    m_idleDrivers.append(ocrDriver);
+    qCInfo(dmOcr) << "OCR driver initialization completed, pool size limit:" << m_maxPoolSize
+                  << "loaded engine limit:" << m_driverLimit
+                  << "inference cpus:" << m_inferenceCpus
+                  << "threads per engine:" << (m_threadCount > 0 ? QString::number(m_threadCount.load()) : QStringLiteral("auto"));
+
+    //线程数配置修改后实时生效，正在识别的实例在下次借出时更新
+    QObject::connect(DConfigManager::instance(), &DConfigManager::valueChanged, DConfigManager::instance(),
+                     [this](const QString &config, const QString &key) {
+        if (config != COMMON_GROUP || key != COMMON_OCRTHREADCOUNT) {
+            return;
+        }
+        m_threadCount = calculateThreadCount();
+        qCInfo(dmOcr) << "OCR thread count changed to:" << m_threadCount;
+    });
+}
+
+quint64 OCREngine::modelIdentity() const
+{
+    //插件名称加上OCR插件库和推理库的路径、大小和修改时间，插件或推理库升级后标识改变
+    //只按路径挑选这些库，其他线程同时加载的无关库不影响结果
+    QStringList libraries;
+    for (const QString &library : SystemInfo::loadedLibraries()) {
+        const QString fileName = QFileInfo(library).fileName();
+        if (library.contains(kOcrLibraryMarker, Qt::CaseInsensitive) || fileName.contains(kInferenceLibraryMarker, Qt::CaseInsensitive)) {
+            libraries << library;
+        }
+    }
+    libraries.sort();
+    libraries.removeDuplicates();
+
+    QByteArray identity = m_pluginName.toUtf8();
+    for (const QString &library : libraries) {
+        QFileInfo info(library);
+        identity += '|' + library.toUtf8() + ':' + QByteArray::number(info.size()) + ':'
+                    + QByteArray::number(info.lastModified().toMSecsSinceEpoch());
+    }
+    if (libraries.isEmpty()) {
+        qCWarning(dmOcr) << "No plugin library found for model identity, using plugin name only";
+    }
+    return ImageHash::hash(identity.constData(), identity.size());
 }
 
-void OCREngine::setImage(const QImage &image)
+int OCREngine::inferenceCpuCount()
 {
-    auto inputImage = image.convertToFormat(QImage::Format_RGB888);
-    ocrDriver->setImage(image);
+    //超线程的兄弟线程共享计算单元，推理线程按可用CPU中的物理核心折算
+    int count = SystemInfo::availableCpuCount();
+    const HardwareInfo &hardware = HardwareProbe::info();
+    if (hardware.physicalCores > 0 && hardware.logicalCpus > hardware.physicalCores) {
+        count = qMax(1, count * hardware.physicalCores / hardware.logicalCpus);
+    }
+    return count;
 }
 
-QString OCREngine::getRecogitionResult()
+int OCREngine::calculatePoolSize()
 {
-    qCInfo(dmOcr) << "Starting OCR recognition";
-    m_isRunning = true;
+    int size = DConfigManager::instance()->value(COMMON_GROUP, COMMON_ENGINEPOOLSIZE, 0).toInt();
+    if (size <= 0) {
+        //自动计算：按可用CPU个数分配，每个实例至少占用kThreadsPerEngine个线程
+        size = qBound(1, inferenceCpuCount() / kThreadsPerEngine, kMaxAutoPoolSize);
+    }
+
+    //内存不足时限制实例个数，至少保留一个实例
+    qint64 available = SystemInfo::availableMemory();
+    if (available > 0) {
+        int memoryLimit = static_cast<int>(qMax<qint64>(1, available / kEngineMemoryEstimate));
+        if (memoryLimit < size) {
+            qCInfo(dmOcr) << "Engine pool size limited by available memory:" << available / 1024 / 1024 << "MB";
+            size = memoryLimit;
+        }
+    }
+    return size;
+}
+
+int OCREngine::calculateDriverLimit(int poolSize)
+{
+    qint64 budget = DConfigManager::instance()->value(COMMON_GROUP, COMMON_LANGUAGEENGINEMEMORY, 0).toLongLong() * 1024 * 1024;
+    if (budget <= 0) {
+        return poolSize;
+    }
+    //预算不超过当前可用内存，且至少能容纳引擎池的实例
+    qint64 available = SystemInfo::availableMemory();
+    if (available > 0) {
+        budget = qMin(budget, available);
+    }
+    return qMax(poolSize, static_cast<int>(budget / kEngineMemoryEstimate));
+}
+
+int OCREngine::calculateThreadCount() const
+{
+    return qMax(0, DConfigManager::instance()->value(COMMON_GROUP, COMMON_OCRTHREADCOUNT, 0).toInt());
+}
+
+Dtk::Ocr::DOcr *OCREngine::createDriver()
+{
+    auto driver = new Dtk::Ocr::DOcr;
+    if (m_isV5) {
+        driver->loadPlugin(kPluginV5);
+    } else {
+        driver->loadDefaultPlugin();
+    }
+    if (m_useVulkan) {
+        driver->setUseHardware({{Dtk::Ocr::HardwareID::GPU_Vulkan, 0}});
+    }
+    return driver;
+}
+
+Dtk::Ocr::DOcr *OCREngine::acquireDriver(int timeoutMs, const QString &language)
+{
+    QMutexLocker locker(&m_poolMutex);
+    while (true) {
+        //同时识别的实例个数不超过引擎池上限，其余实例只保留已加载的模型
+        if (m_runningCount < m_maxPoolSize) {
+            Dtk::Ocr::DOcr *driver = takeIdleDriver(language);
+            if (driver) {
+                ++m_runningCount;
+                applyThreadCount(driver);
+                return driver;
+            }
+            if (m_drivers.size() + m_creatingCount < m_driverLimit) {
+                //加载模型耗时较长，创建期间不持有锁，避免阻塞归还操作
+                ++m_creatingCount;
+                ++m_runningCount;
+                qCInfo(dmOcr) << "Creating OCR driver instance" << m_drivers.size() + m_creatingCount << "of" << m_driverLimit
+                              << "for language:" << language;
+                locker.unlock();
+                driver = createDriver();
+                locker.relock();
+                --m_creatingCount;
+                m_drivers.append(driver);
+                applyThreadCount(driver);
+                return driver;
+            }
+            //实例个数已达上限，复用最久未使用的空闲实例，借出后重新加载语言
+            if (!m_idleDrivers.isEmpty()) {
+                driver = m_idleDrivers.takeFirst();
+                ++m_runningCount;
+                applyThreadCount(driver);
+                return driver;
+            }
+        }
+        if (timeoutMs < 0) {
+            m_poolCondition.wait(&m_poolMutex);
+        } else if (!m_poolCondition.wait(&m_poolMutex, static_cast<unsigned long>(timeoutMs))) {
+            return nullptr;
+        }
+    }
+}
+
+Dtk::Ocr::DOcr *OCREngine::takeIdleDriver(const QString &language)
+{
+    //优先借出已加载目标语言的实例，不需要切换模型；其次借出最近使用的实例
+    for (int i = m_idleDrivers.size() - 1; i >= 0; --i) {
+        if (!language.isEmpty() && m_driverLanguage.value(m_idleDrivers.at(i)) == language) {
+            return m_idleDrivers.takeAt(i);
+        }
+    }
+    //按语言保留实例时，其他语言的实例留给对应语言使用
+    if (language.isEmpty() || m_driverLimit <= m_maxPoolSize) {
+        return m_idleDrivers.isEmpty() ? nullptr : m_idleDrivers.takeLast();
+    }
+    return nullptr;
+}
+
+void OCREngine::applyThreadCount(Dtk::Ocr::DOcr *driver)
+{
+    int threadCount = m_threadCount;
+    if (threadCount <= 0) {
+        //自动计算：可用CPU平均分配给当前借出的实例(包括本实例)，单个请求可以使用全部空闲核心；
+        //已借出的实例在下次借出时才调整，并发开始时短暂超额，不打断正在进行的识别
+        threadCount = qMax(1, m_inferenceCpus / qMax(1, static_cast<int>(m_runningCount)));
+    }
+    if (m_driverThreads.value(driver) != threadCount) {
+        driver->setUseMaxThreadsCount(threadCount);
+        m_driverThreads.insert(driver, threadCount);
+    }
+}
+
+void OCREngine::releaseDriver(Dtk::Ocr::DOcr *driver)
+{
+    if (driver == nullptr) {
+        return;
+    }
+    QMutexLocker locker(&m_poolMutex);
+    //空闲列表按归还顺序排列，列表头部为最久未使用的实例
+    m_idleDrivers.append(driver);
+    --m_runningCount;
+    //等待的调用方需要的语言可能不同，全部唤醒各自选择
+    m_poolCondition.wakeAll();
+}
+
+void OCREngine::setDriverImage(Dtk::Ocr::DOcr *driver, const QImage &image)
+{
+    //recognize中已转换为插件格式，插件内部不再转换
+    Q_ASSERT(image.format() == ImageIngest::DriverFormat);
+    driver->setImage(image);
+}
+
+void OCREngine::warmUpInference()
+{
+    QImage image(320, 64, QImage::Format_RGB888);
+    image.fill(Qt::white);
+    {
+        QPainter painter(&image);
+        QFont font = painter.font();
+        font.setPixelSize(32);
+        painter.setFont(font);
+        painter.setPen(Qt::black);
+        painter.drawText(image.rect(), Qt::AlignCenter, QStringLiteral("OCR 2026"));
+    }
+
+    QString language = resolveLanguage(QString());
+    if (language == ScriptDetector::AutoLanguage) {
+        language = ScriptDetector::ProbeLanguage;
+    }
+    auto driver = acquireDriver(-1, language);
+    prepareLanguage(driver, language);
+    setDriverImage(driver, image);
+    driver->analyze();
+    releaseDriver(driver);
+}
+
+QString OCREngine::resolveLanguage(const QString &language) const
+{
+    if (!language.isEmpty()) {
+        return language;
+    }
+    QMutexLocker locker(&m_poolMutex);
+    return m_language;
+}
+
+QImage OCREngine::prepareInput(const QImage &image, QTransform *toSource, int *orientation, qint64 *bytesCopied) const
+{
+    //页面方向只作用于送入识别的图片，界面显示的图片不变
+    QImage oriented = image;
+    QTransform toOriented;
+    *orientation = m_autoOrientation ? ImagePreprocess::detectOrientation(image) : 0;
+    if (*orientation != 0) {
+        QTransform rotate;
+        rotate.rotate(*orientation);
+        toOriented = QImage::trueMatrix(rotate, image.width(), image.height());
+        oriented = image.transformed(rotate);
+        *bytesCopied += oriented.sizeInBytes();
+        qCInfo(dmOcr) << "Rotating input by" << *orientation << "degrees before recognition";
+    }
+
+    //缩放到目标文字行高后识别，分块判断基于缩放后的尺寸
+    qreal scale = 1.0;
+    QImage input = ImagePreprocess::normalizeResolution(oriented, m_targetTextHeight, &scale);
+    if (input.constBits() != oriented.constBits()) {
+        *bytesCopied += input.sizeInBytes();
+    }
+    *toSource = QTransform::fromScale(1.0 / scale, 1.0 / scale) * toOriented.inverted();
+    //整张图片只转换一次格式，分块和识别都直接使用转换后的数据
+    return ImageIngest::toDriverFormat(input, bytesCopied);
+}
+
+bool OCREngine::needsTiling(const QImage &input) const
+{
+    return m_tileSize > 0 && qMax(input.width(), input.height()) > m_tileSize;
+}
+
+QImage OCREngine::cropRegion(const QImage &image, const QRect &region, QPoint *origin)
+{
+    *origin = QPoint();
+    if (region.isNull() || region.contains(image.rect())) {
+        return image;
+    }
+    //只复制区域内的像素，后续预处理和识别的开销与区域大小相关
+    const QRect rect = region.intersected(image.rect());
+    if (rect.isEmpty()) {
+        qCWarning(dmOcr) << "Recognition region outside image:" << region << "image size:" << image.size();
+        return QImage();
+    }
+    *origin = rect.topLeft();
+    qCInfo(dmOcr) << "Recognizing region" << rect << "of image size:" << image.size();
+    return image.copy(rect);
+}
+
+void OCREngine::mapToSource(QList<OcrTextBox> &boxes, const QTransform &toSource)
+{
+    if (toSource.isIdentity()) {
+        return;
+    }
+    for (OcrTextBox &box : boxes) {
+        box.polygon = toSource.map(box.polygon);
+    }
+}
+
+QString OCREngine::recognize(const QImage &source, const QString &language, OcrCancelToken *token,
+                             const OcrPartialResultCallback &partial, const QRect &region)
+{
+    QString targetLanguage = resolveLanguage(language);
+    QPoint origin;
+    const QImage image = cropRegion(source, region, &origin);
+    if (image.isNull()) {
+        return QString();
+    }
+
+    //相同图片、语言和插件的结果直接从缓存返回，不再借出引擎
+    //先查内存缓存，再查上次运行留下的持久化缓存
+    const quint64 digest = m_resultCache->digest(image);
+    //流式识别按条带拼接文本，与整图识别的文本格式不同，缓存和画面去重分开记录
+    const QString variant = partial ? kStreamVariant : QString();
+    QString cacheKey;
+    if (m_resultCache->isEnabled() || m_diskCache->isEnabled()) {
+        cacheKey = ResultCache::makeKey(digest, targetLanguage, m_pluginName, variant);
+        QString cached;
+        if (m_resultCache->find(cacheKey, &cached)) {
+            return cached;
+        }
+        if (m_diskCache->find(cacheKey, &cached)) {
+            qCInfo(dmOcr) << "Result loaded from persistent cache";
+            m_resultCache->insert(cacheKey, cached);
+            return cached;
+        }
+    }
+
+    //与最近的画面相似时复用结果，只有小块区域变化时只识别该区域
+    FrameHistory::Signature frame;
+    if (m_frameHistory && region.isNull()) {
+        frame = FrameHistory::signature(image);
+        QString result;
+        QList<OcrTextBox> previous;
+        QRect changed;
+        switch (m_frameHistory->match(frame, targetLanguage + variant, &result, &previous, &changed)) {
+        case FrameHistory::Unchanged:
+            return result;
+        case FrameHistory::RegionChanged: {
+            int orientation = 0;
+            QList<OcrTextBox> boxes = recognizeBoxes(image, targetLanguage, token, changed, &orientation);
+            if (token && token->isCancelled()) {
+                qCInfo(dmOcr) << "OCR recognition cancelled";
+                return QString();
+            }
+            boxes = FrameHistory::splice(previous, changed, boxes);
+            result = TileLayout::toText(boxes);
+            m_frameHistory->insert(frame, targetLanguage + variant, result, boxes);
+            return result;
+        }
+        case FrameHistory::NoMatch:
+            break;
+        }
+    }
+
+    const QString requestLanguage = targetLanguage;
+    QTransform toSource;
+    int orientation = 0;
+    qint64 bytesCopied = 0;
+    const QImage input = prepareInput(image, &toSource, &orientation, &bytesCopied);
+    if (targetLanguage == ScriptDetector::AutoLanguage) {
+        targetLanguage = detectLanguage(input, token);
+    }
+
+    QString result;
+    QList<OcrTextBox> boxes;
+    QElapsedTimer passTimer;
+    passTimer.start();
+    if (recognizeDetected(digest, targetLanguage, token, &boxes)) {
+        //同一图片只切换了语言，已在保存的文本行上重新识别
+        result = TileLayout::toText(boxes);
+    } else if (needsTiling(input)) {
+        const QList<TileLayout::Tile> tiles = TileLayout::split(input.size(), m_tileSize, m_tileOverlap);
+        boxes = analyzeTiles(input, tiles, targetLanguage, token, partial, &bytesCopied);
+        storeDetection(digest, input, targetLanguage, boxes, token, passTimer.elapsed());
+        result = TileLayout::toText(boxes);
+    } else if (partial && streamsImage(input.size())) {
+        //需要部分结果时按水平条带识别，上方的条带完成后即可回调
+        const QList<TileLayout::Tile> bands = TileLayout::split(input.size(), QSize(input.width(), kStreamBandHeight), kStreamBandOverlap);
+        boxes = analyzeTiles(input, bands, targetLanguage, token, partial, &bytesCopied);
+        storeDetection(digest, input, targetLanguage, boxes, token, passTimer.elapsed());
+        result = TileLayout::toText(boxes);
+    } else {
+        result = recognizeWhole(input, targetLanguage, token, &boxes);
+        storeDetection(digest, input, targetLanguage, boxes, token, passTimer.elapsed());
+    }
+    qCInfo(dmOcr) << "Image ingest, source format:" << image.format() << "source bytes:" << image.sizeInBytes()
+                  << "bytes copied:" << bytesCopied;
+
+    if (token && token->isCancelled()) {
+        qCInfo(dmOcr) << "OCR recognition cancelled";
+        return QString();
+    }
+    if (!cacheKey.isEmpty()) {
+        m_resultCache->insert(cacheKey, result);
+        m_diskCache->insert(cacheKey, result);
+    }
+    if (!frame.isNull()) {
+        mapToSource(boxes, toSource);
+        m_frameHistory->insert(frame, requestLanguage + variant, result, boxes);
+    }
+    return result;
+}
+
+bool OCREngine::streamsImage(const QSize &size)
+{
+    return size.height() > kStreamBandHeight * 2;
+}
+
+OcrResult OCREngine::recognizeResult(const QImage &source, const QString &language, OcrCancelToken *token, const QRect &region)
+{
+    int orientation = 0;
+    const QList<OcrTextBox> boxes = recognizeBoxes(source, language, token, region, &orientation);
+    if (token && token->isCancelled()) {
+        return OcrResult();
+    }
+    OcrResult result = OcrResult::fromBoxes(boxes);
+    result.orientation = orientation;
+    return result;
+}
+
+QList<OcrTextBox> OCREngine::recognizeBoxes(const QImage &source, const QString &language, OcrCancelToken *token,
+                                            const QRect &region, int *orientation)
+{
+    QString targetLanguage = resolveLanguage(language);
+    QPoint origin;
+    const QImage image = cropRegion(source, region, &origin);
+    if (image.isNull()) {
+        return QList<OcrTextBox>();
+    }
+    QTransform toSource;
+    qint64 bytesCopied = 0;
+    const QImage input = prepareInput(image, &toSource, orientation, &bytesCopied);
+    if (targetLanguage == ScriptDetector::AutoLanguage) {
+        targetLanguage = detectLanguage(input, token);
+    }
+
+    QList<OcrTextBox> boxes;
+    if (needsTiling(input)) {
+        const QList<TileLayout::Tile> tiles = TileLayout::split(input.size(), m_tileSize, m_tileOverlap);
+        boxes = analyzeTiles(input, tiles, targetLanguage, token, OcrPartialResultCallback(), &bytesCopied);
+    } else {
+        runOnDriver(targetLanguage, token, [this, &input, &boxes](Dtk::Ocr::DOcr *driver) {
+            boxes = analyzeBoxes(driver, input);
+        });
+    }
+
+    if (token && token->isCancelled()) {
+        qCInfo(dmOcr) << "OCR recognition cancelled";
+        return QList<OcrTextBox>();
+    }
+    mapToSource(boxes, toSource * QTransform::fromTranslate(origin.x(), origin.y()));
+    qCInfo(dmOcr) << "Structured OCR recognition completed, text boxes:" << boxes.size() << "bytes copied:" << bytesCopied;
+    return boxes;
+}
 
-    ocrDriver->analyze();
-    QString result = ocrDriver->simpleResult();
-    m_isRunning = false;
+void OCREngine::prepareLanguage(Dtk::Ocr::DOcr *driver, const QString &language)
+{
+    QString loadedLanguage;
+    {
+        QMutexLocker locker(&m_poolMutex);
+        loadedLanguage = m_driverLanguage.value(driver);
+    }
+    //实例加载的语言不一致时才切换模型
+    if (!language.isEmpty() && loadedLanguage != language) {
+        if (driver->setLanguage(language)) {
+            QMutexLocker locker(&m_poolMutex);
+            m_driverLanguage.insert(driver, language);
+        } else {
+            qCWarning(dmOcr) << "Failed to set language:" << language;
+        }
+    }
+}
+
+QString OCREngine::detectLanguage(const QImage &input, OcrCancelToken *token)
+{
+    QImage sample = ScriptDetector::sampleImage(input);
+    if (sample.isNull()) {
+        return ScriptDetector::ProbeLanguage;
+    }
+    sample = ImageIngest::toDriverFormat(sample);
+
+    //空闲实例已加载可用于探测的中文模型时直接使用，不为探测切换模型
+    QString probeLanguage = ScriptDetector::ProbeLanguage;
+    {
+        QMutexLocker locker(&m_poolMutex);
+        for (int i = m_idleDrivers.size() - 1; i >= 0; --i) {
+            const QString loaded = m_driverLanguage.value(m_idleDrivers.at(i));
+            if (ScriptDetector::canProbe(loaded)) {
+                probeLanguage = loaded;
+                break;
+            }
+        }
+    }
+
+    QString text;
+    runOnDriver(probeLanguage, token, [this, &sample, &text](Dtk::Ocr::DOcr *driver) {
+        setDriverImage(driver, sample);
+        driver->analyze();
+        text = driver->simpleResult();
+    });
+    const QString language = ScriptDetector::classify(text);
+    ScriptDetector::recordDetection(language);
+    return language;
+}
+
+void OCREngine::storeDetection(quint64 digest, const QImage &input, const QString &language, const QList<OcrTextBox> &boxes,
+                               OcrCancelToken *token, qint64 elapsedMs)
+{
+    //取消时文本框不完整，不保存
+    if (token && token->isCancelled()) {
+        return;
+    }
+
+    //文本框外扩少量边距，避免裁掉笔画
+    QList<QRect> rects;
+    for (const OcrTextBox &box : boxes) {
+        QRect rect = box.polygon.boundingRect().toAlignedRect();
+        const int padding = qMax(2, rect.height() / 5);
+        rect = rect.adjusted(-padding, -padding, padding, padding).intersected(input.rect());
+        if (!rect.isEmpty()) {
+            rects << rect;
+        }
+    }
+
+    //只保存文本区域拼成的窄条，不持有整张预处理后的图片；文本行过多时窄条过高，不保存
+    Detection detection;
+    detection.digest = digest;
+    detection.language = language;
+    detection.rects = rects;
+    detection.elapsedMs = elapsedMs;
+    if (!rects.isEmpty()) {
+        detection.strip = buildStrip(input, rects, &detection.offsets);
+    }
+    if (detection.strip.isNull()) {
+        detection.rects.clear();
+    }
+
+    QMutexLocker locker(&m_detectionMutex);
+    m_detection = detection;
+}
+
+QImage OCREngine::buildStrip(const QImage &input, const QList<QRect> &rects, QList<int> *offsets) const
+{
+    //文本行裁剪后纵向排列，行间留出空白，避免检测把相邻两行连在一起
+    QVector<int> heights;
+    int width = 0;
+    for (const QRect &rect : rects) {
+        heights << rect.height();
+        width = qMax(width, rect.width());
+    }
+    std::nth_element(heights.begin(), heights.begin() + heights.size() / 2, heights.end());
+    const int gap = qMax(8, heights.at(heights.size() / 2) / 2);
+    int height = gap;
+    for (const QRect &rect : rects) {
+        *offsets << height;
+        height += rect.height() + gap;
+    }
+    //文本行过多时拼接图过高，切换语言时仍按整图识别
+    if (m_tileSize > 0 && height > m_tileSize) {
+        offsets->clear();
+        return QImage();
+    }
+
+    QImage strip(width, height, ImageIngest::DriverFormat);
+    strip.fill(input.pixelColor(0, 0));
+    {
+        QPainter painter(&strip);
+        for (int i = 0; i < rects.size(); ++i) {
+            painter.drawImage(QPoint(0, offsets->at(i)), input, rects.at(i));
+        }
+    }
+    return strip;
+}
+
+bool OCREngine::recognizeDetected(quint64 digest, const QString &language, OcrCancelToken *token, QList<OcrTextBox> *result)
+{
+    QImage strip;
+    QList<QRect> rects;
+    QList<int> offsets;
+    qint64 fullPassMs = 0;
+    {
+        QMutexLocker locker(&m_detectionMutex);
+        if (m_detection.digest != digest || m_detection.language == language || m_detection.rects.isEmpty()) {
+            return false;
+        }
+        strip = m_detection.strip;
+        rects = m_detection.rects;
+        offsets = m_detection.offsets;
+        fullPassMs = m_detection.elapsedMs;
+    }
+
+    //插件只提供检测加识别的完整analyze，没有只识别给定文本框的接口；
+    //在保存的文字区域窄条上完整识别，检测仍会执行，但只处理文字区域，空白和图片部分不再计算
+    qCInfo(dmOcr) << "Reusing detected text regions for language" << language << "regions:" << rects.size()
+                  << "strip size:" << strip.size();
+
+    QElapsedTimer timer;
+    timer.start();
+    QList<OcrTextBox> boxes;
+    runOnDriver(language, token, [this, &strip, &boxes](Dtk::Ocr::DOcr *driver) {
+        boxes = analyzeBoxes(driver, strip);
+    });
+    //记录与整图识别的实际耗时对比，两者都包含切换语言模型的时间
+    qCInfo(dmOcr) << "Strip recognition took" << timer.elapsed() << "ms, previous full pass took" << fullPassMs << "ms";
+
+    //按中心点所在的区域映射回原图位置，恢复原来的版面
+    for (OcrTextBox &box : boxes) {
+        const qreal centerY = box.polygon.boundingRect().center().y();
+        auto it = std::upper_bound(offsets.begin(), offsets.end(), static_cast<int>(centerY));
+        const int index = qMax(0, static_cast<int>(it - offsets.begin()) - 1);
+        box.polygon.translate(rects.at(index).topLeft() - QPoint(0, offsets.at(index)));
+    }
+    *result = boxes;
+    return true;
+}
+
+void OCREngine::runOnDriver(const QString &language, OcrCancelToken *token, const std::function<void(Dtk::Ocr::DOcr *)> &work)
+{
+    auto driver = acquireDriver(-1, language);
+    prepareLanguage(driver, language);
+    if (token) {
+        token->attach(driver);
+    }
+    if (!token || !token->isCancelled()) {
+        work(driver);
+    }
+    if (token) {
+        token->detach(driver);
+    }
+    releaseDriver(driver);
+}
+
+QString OCREngine::recognizeWhole(const QImage &image, const QString &language, OcrCancelToken *token, QList<OcrTextBox> *boxes)
+{
+    qCInfo(dmOcr) << "Starting OCR recognition";
+    QString result;
+    runOnDriver(language, token, [this, &image, &result, boxes](Dtk::Ocr::DOcr *driver) {
+        setDriverImage(driver, image);
+        driver->analyze();
+        result = driver->simpleResult();
+        //保存各文本框，用于切换语言时重新识别和相似画面的局部更新
+        auto textBoxes = driver->textBoxes();
+        for (int i = 0; i < textBoxes.size(); ++i) {
+            OcrTextBox box;
+            for (const QPointF &point : textBoxes.at(i).points) {
+                box.polygon << point;
+            }
+            box.text = driver->resultFromBox(i);
+            *boxes << box;
+        }
+    });
     qCInfo(dmOcr) << "OCR recognition completed";
     return result;
 }
 
+QList<OcrTextBox> OCREngine::analyzeBoxes(Dtk::Ocr::DOcr *driver, const QImage &image)
+{
+    setDriverImage(driver, image);
+    driver->analyze();
+
+    QList<OcrTextBox> result;
+    auto boxes = driver->textBoxes();
+    for (int i = 0; i < boxes.size(); ++i) {
+        OcrTextBox box;
+        for (const QPointF &point : boxes.at(i).points) {
+            box.polygon << point;
+        }
+        box.text = driver->resultFromBox(i);
+        result << box;
+    }
+    return result;
+}
+
+QList<OcrTextBox> OCREngine::analyzeTiles(const QImage &image, const QList<TileLayout::Tile> &tiles, const QString &language,
+                                          OcrCancelToken *token, const OcrPartialResultCallback &partial, qint64 *bytesCopied)
+{
+    qCInfo(dmOcr) << "Starting tiled OCR recognition, image size:" << image.size() << "tiles:" << tiles.size();
+
+    //分块按行优先排列，同一行的分块顶边相同
+    QList<QList<int>> rows;
+    for (int i = 0; i < tiles.size(); ++i) {
+        if (rows.isEmpty() || tiles.at(rows.last().first()).rect.top() != tiles.at(i).rect.top()) {
+            rows << QList<int>();
+        }
+        rows.last() << i;
+    }
+
+    //各分块并行识别，结果写入各自的位置
+    std::vector<QList<OcrTextBox>> tileBoxes(static_cast<size_t>(tiles.size()));
+    std::vector<bool> tileDone(static_cast<size_t>(tiles.size()), false);
+    int nextPartialRow = 0;
+    QMutex partialMutex;
+    //按阅读顺序回调已完成的行，持有锁保证回调顺序
+    auto reportPartial = [&](int index) {
+        QMutexLocker locker(&partialMutex);
+        tileDone[static_cast<size_t>(index)] = true;
+        while (nextPartialRow < rows.size()) {
+            const QList<int> &row = rows.at(nextPartialRow);
+            if (!std::all_of(row.begin(), row.end(), [&tileDone](int i) { return tileDone[static_cast<size_t>(i)]; })) {
+                break;
+            }
+            QList<TileLayout::Tile> rowTiles;
+            std::vector<QList<OcrTextBox>> rowBoxes;
+            for (int i : row) {
+                rowTiles << tiles.at(i);
+                rowBoxes.push_back(tileBoxes[static_cast<size_t>(i)]);
+            }
+            const QString text = TileLayout::toText(TileLayout::merge(rowTiles, rowBoxes));
+            if (!text.isEmpty() && (!token || !token->isCancelled())) {
+                partial(text);
+            }
+            ++nextPartialRow;
+        }
+    };
+
+    std::atomic<qint64> tileBytes {0};
+    QSemaphore finished;
+    for (int i = 0; i < tiles.size(); ++i) {
+        m_tilePool->start(new FunctionRunnable([this, &image, &language, &tiles, &tileBoxes, &tileBytes, &finished,
+                                                &partial, &reportPartial, token, i]() {
+            if (!token || !token->isCancelled()) {
+                runOnDriver(language, token, [this, &image, &tiles, &tileBoxes, &tileBytes, i](Dtk::Ocr::DOcr *driver) {
+                    QImage tileImage = image.copy(tiles.at(i).rect);
+                    tileBytes += tileImage.sizeInBytes();
+                    tileBoxes[static_cast<size_t>(i)] = analyzeBoxes(driver, tileImage);
+                });
+            }
+            if (partial) {
+                reportPartial(i);
+            }
+            finished.release();
+        }));
+    }
+    finished.acquire(tiles.size());
+    if (bytesCopied) {
+        *bytesCopied += tileBytes;
+    }
+
+    QList<OcrTextBox> boxes = TileLayout::merge(tiles, tileBoxes);
+    qCInfo(dmOcr) << "Tiled OCR recognition completed, text boxes:" << boxes.size();
+    return boxes;
+}
+
+QList<OcrBatchResult> OCREngine::recognizeBatch(const QList<OcrBatchItem> &items, const QString &language, OcrCancelToken *token,
+                                                const OcrBatchProgressCallback &progress)
+{
+    const int count = items.size();
+    std::vector<OcrBatchResult> results(static_cast<size_t>(count));
+    if (count == 0) {
+        return QList<OcrBatchResult>();
+    }
+    const QString targetLanguage = resolveLanguage(language);
+    qCInfo(dmOcr) << "Starting batch recognition, items:" << count << "language:" << targetLanguage;
+    QElapsedTimer batchTimer;
+    batchTimer.start();
+
+    //解码与识别并行：每个识别线程取出一项后，立即开始解码预取窗口末尾的一项
+    const int workerCount = qMin(m_maxPoolSize, count);
+    const int window = workerCount + kBatchPrefetch;
+    std::vector<QImage> images(static_cast<size_t>(count));
+    std::vector<QSemaphore> decoded(static_cast<size_t>(count));
+    QThreadPool decodePool;
+    decodePool.setMaxThreadCount(kBatchDecodeThreads);
+    auto startDecode = [&items, &images, &results, &decoded, &decodePool](int index) {
+        decodePool.start(new FunctionRunnable([&items, &images, &results, &decoded, index]() {
+            QElapsedTimer timer;
+            timer.start();
+            const OcrBatchItem &item = items.at(index);
+            QImage image = item.image;
+            if (image.isNull() && !item.path.isEmpty()) {
+                image.load(item.path);
+            } else if (image.isNull()) {
+                image.loadFromData(item.data);
+            }
+            images[static_cast<size_t>(index)] = image;
+            results[static_cast<size_t>(index)].decodeMs = timer.elapsed();
+            decoded[static_cast<size_t>(index)].release();
+        }));
+    };
+    for (int i = 0; i < qMin(window, count); ++i) {
+        startDecode(i);
+    }
+
+    std::atomic_int next {0};
+    QThreadPool workers;
+    workers.setMaxThreadCount(workerCount);
+    for (int w = 0; w < workerCount; ++w) {
+        workers.start(new FunctionRunnable([&, this]() {
+            for (int index = next++; index < count; index = next++) {
+                if (index + window < count) {
+                    startDecode(index + window);
+                }
+                decoded[static_cast<size_t>(index)].acquire();
+                OcrBatchResult &result = results[static_cast<size_t>(index)];
+                const QImage image = std::move(images[static_cast<size_t>(index)]);
+                if (image.isNull()) {
+                    qCWarning(dmOcr) << "Batch item" << index << "could not be decoded";
+                } else if (!token || !token->isCancelled()) {
+                    QElapsedTimer timer;
+                    timer.start();
+                    result.text = recognize(image, targetLanguage, token);
+                    result.recognizeMs = timer.elapsed();
+                    result.success = !token || !token->isCancelled();
+                }
+                if (progress) {
+                    progress(index, result);
+                }
+            }
+        }));
+    }
+    workers.waitForDone();
+    decodePool.waitForDone();
+
+    const qint64 elapsed = qMax<qint64>(1, batchTimer.elapsed());
+    qCInfo(dmOcr) << "Batch recognition completed, items:" << count << "elapsed:" << elapsed << "ms throughput:"
+                  << count * 1000.0 / elapsed << "images/s";
+    QList<OcrBatchResult> batchResults;
+    batchResults.reserve(count);
+    for (const OcrBatchResult &result : results) {
+        batchResults << result;
+    }
+    return batchResults;
+}
+
 bool OCREngine::setLanguage(const QString &language)
 {
     qCInfo(dmOcr) << "Setting OCR language to:" << language;
-    if(ocrDriver->isRunning()) {
-        qCInfo(dmOcr) << "Breaking current analysis for language change";
-        ocrDriver->breakAnalyze();
+
+    //有空闲实例时立即加载，用于校验语言是否可用；否则在下次识别时加载
+    //已有实例加载了该语言时直接切换，不需要重新加载模型
+    //自动选择语言时在每次识别前确定语言，不需要加载
+    bool success = true;
+    auto driver = language == ScriptDetector::AutoLanguage ? nullptr : acquireDriver(0, language);
+    if (driver) {
+        QMutexLocker locker(&m_poolMutex);
+        bool loaded = m_driverLanguage.value(driver) == language;
+        locker.unlock();
+        if (!loaded) {
+            success = driver->setLanguage(language);
+            if (success) {
+                locker.relock();
+                m_driverLanguage.insert(driver, language);
+                locker.unlock();
+            }
+        }
+        releaseDriver(driver);
     }
 
-    bool success = ocrDriver->setLanguage(language);
     if (!success) {
         qCWarning(dmOcr) << "Failed to set language:" << language;
+        return false;
     }
-    return success;
+
+    QMutexLocker locker(&m_poolMutex);
+    m_language = language;
+    return true;
+}
+
+QString OCREngine::language() const
+{
+    QMutexLocker locker(&m_poolMutex);
+    return m_language;
 }
 
 bool OCREngine::isGpuEnable()
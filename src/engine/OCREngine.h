@@ -7,6 +7,15 @@
 #include <atomic>
 #include <QImage>
 #include <QString>
+#include <QList>
+#include <QHash>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QFuture>
+#include <QTransform>
+
+#include "ocrresult.h"
+#include "tilelayout.h"
 
 namespace Dtk {
 namespace Ocr {
@@ -15,25 +24,92 @@ class DOcr;
 }
 
 class QSettings;
+class OcrCancelToken;
+class ResultCache;
+class DiskResultCache;
+class FrameHistory;
+class QThreadPool;
 
+/*
+ * @bref: OCREngine 管理一组已初始化的DOcr实例(引擎池)
+ * 每次识别从池中借出一个空闲实例，识别完成后归还，多个调用方可以并行识别
+*/
 class OCREngine
 {
 public:
+    // 首次调用时创建引擎，可在任意线程调用；预热进行中时会等待创建完成
     static OCREngine *instance();
 
-    bool isRunning() const
-    {
-        return m_isRunning;
-    }
+    /*
+    * @bref: startWarmUp 在后台线程创建引擎并执行一次预热识别
+    * 只在第一次调用时启动，之后返回同一个future
+    */
+    static QFuture<void> startWarmUp();
+    // 引擎就绪(预热完成)的future，未启动预热时返回已完成的future
+    static QFuture<void> readiness();
 
     bool isV5() const
     {
         return m_isV5;
     }
 
+    // 设置默认识别语言，recognize未指定语言时使用，ScriptDetector::AutoLanguage表示每次识别前自动选择
     bool setLanguage(const QString &language);
-    void setImage(const QImage &image);
-    QString getRecogitionResult();
+    QString language() const;
+
+    /*
+    * @bref: recognize 借出一个引擎实例识别图片，可在任意线程调用
+    * 识别前先查询结果缓存，命中时不占用引擎
+    * @param: image 待识别图片
+    * @param: language 识别语言，为空时使用默认语言
+    * @param: token 取消标记，取消后中断识别并返回空结果
+    * @param: partial 部分结果回调，不为空时较高的图片按水平条带识别，每完成一段按阅读顺序回调；
+    *          条带拼接的文本与整图识别不同，只在调用方需要流式结果时传入，结果单独缓存
+    * @param: region 识别区域(图片坐标)，为空时识别整张图片
+    * @return: 识别结果文本
+    */
+    QString recognize(const QImage &image, const QString &language = QString(), OcrCancelToken *token = nullptr,
+                      const OcrPartialResultCallback &partial = OcrPartialResultCallback(), const QRect &region = QRect());
+
+    // 流式识别时该尺寸的图片是否按条带识别；较矮的图片总是整图识别，调用方不必以流式提交
+    static bool streamsImage(const QSize &size);
+
+    /*
+    * @bref: recognizeResult 识别图片并返回带文本框位置的结构化结果，可在任意线程调用
+    * 结构化结果不经过结果缓存
+    * @param: region 识别区域，为空时识别整张图片；文本框坐标总是整张图片的坐标
+    * @return: 结果，取消时为空
+    */
+    OcrResult recognizeResult(const QImage &image, const QString &language = QString(), OcrCancelToken *token = nullptr,
+                              const QRect &region = QRect());
+
+    /*
+    * @bref: recognizeBatch 批量识别，可在任意线程调用，返回前阻塞
+    * 按引擎池大小并发识别，识别当前图片的同时预先解码后续图片，所有图片使用相同语言以保持模型常驻
+    * @param: items 待识别的图片或图片文件
+    * @param: language 识别语言，为空时使用默认语言
+    * @param: token 取消标记，取消后未开始的项不再识别
+    * @param: progress 每完成一项时回调，不保证按顺序
+    * @return: 与items一一对应的结果
+    */
+    QList<OcrBatchResult> recognizeBatch(const QList<OcrBatchItem> &items, const QString &language = QString(),
+                                         OcrCancelToken *token = nullptr,
+                                         const OcrBatchProgressCallback &progress = OcrBatchProgressCallback());
+
+    /*
+    * @bref: acquireDriver 从引擎池借出一个实例
+    * 优先借出已加载目标语言的空闲实例；没有时未达实例上限则新建实例，
+    * 否则复用最久未使用的空闲实例；同时借出的实例个数达到引擎池上限时等待其他调用方归还
+    * @param: timeoutMs 等待超时时间，-1表示一直等待
+    * @param: language 将要使用的语言，为空时不区分语言
+    * @return: 借出的实例，超时返回nullptr
+    */
+    Dtk::Ocr::DOcr *acquireDriver(int timeoutMs = -1, const QString &language = QString());
+    // 归还借出的实例
+    void releaseDriver(Dtk::Ocr::DOcr *driver);
+
+    // 引擎池的实例个数上限，只计算一次，不需要创建引擎
+    static int maxPoolSize();
 
 private:
     OCREngine();
@@ -44,9 +120,106 @@ private:
 
     // 某些机型，使用GPU进行OCR识别，会导致OCR崩溃
     bool isGpuEnable();
+    // 识别模型的标识，由插件名称和已加载的OCR插件库、推理库的文件信息计算，用于作废持久化的结果
+    quint64 modelIdentity() const;
+    // 用于推理的CPU个数，按硬件探测到的物理核心折算超线程
+    static int inferenceCpuCount();
+    // 根据配置和可用内存计算引擎池上限
+    static int calculatePoolSize();
+    // 已创建实例的个数上限，配置了按语言常驻引擎的内存预算时可超过引擎池上限
+    static int calculateDriverLimit(int poolSize);
+    // 配置的每个实例推理线程数，0表示借出时根据可用CPU和借出的实例个数计算
+    int calculateThreadCount() const;
+    // 取出可直接使用的空闲实例，调用时需持有m_poolMutex
+    Dtk::Ocr::DOcr *takeIdleDriver(const QString &language);
+    // 实例借出时应用线程数，调用时需持有m_poolMutex且已计入m_runningCount
+    void applyThreadCount(Dtk::Ocr::DOcr *driver);
+    // 新建并初始化一个引擎实例，与首个实例使用相同的插件和硬件配置
+    Dtk::Ocr::DOcr *createDriver();
+    void setDriverImage(Dtk::Ocr::DOcr *driver, const QImage &image);
+    // 识别一张合成的文字图片，使插件提前加载模型，结果不写入缓存
+    void warmUpInference();
+    // 实例加载的语言与目标语言不一致时切换语言
+    void prepareLanguage(Dtk::Ocr::DOcr *driver, const QString &language);
+
+    // 语言为空时使用默认语言
+    QString resolveLanguage(const QString &language) const;
+    // 识别图片中的几行文字，按文字种类选择识别语言
+    QString detectLanguage(const QImage &input, OcrCancelToken *token);
+    // 按检测到的页面方向旋转、缩放到目标文字行高并转换为插件格式
+    // toSource输出识别坐标到image坐标的变换，orientation输出顺时针旋转的角度，bytesCopied累加复制的字节数
+    QImage prepareInput(const QImage &image, QTransform *toSource, int *orientation, qint64 *bytesCopied) const;
+    bool needsTiling(const QImage &input) const;
+    // 裁剪出识别区域，origin输出区域在原图中的位置；区域与图片不相交时返回空图片
+    static QImage cropRegion(const QImage &image, const QRect &region, QPoint *origin);
+    // 文本框坐标按预处理的变换映射回原图坐标
+    static void mapToSource(QList<OcrTextBox> &boxes, const QTransform &toSource);
 
-    Dtk::Ocr::DOcr *ocrDriver;
-    std::atomic_bool m_isRunning;
+    // 借出实例、切换语言并绑定取消标记后执行work，已取消时不执行
+    void runOnDriver(const QString &language, OcrCancelToken *token, const std::function<void(Dtk::Ocr::DOcr *)> &work);
+    // 识别图片返回原图坐标的文本框，orientation输出检测到的页面方向
+    QList<OcrTextBox> recognizeBoxes(const QImage &image, const QString &language, OcrCancelToken *token, const QRect &region,
+                                     int *orientation);
+    // 整图识别，boxes输出检测到的文本框
+    QString recognizeWhole(const QImage &image, const QString &language, OcrCancelToken *token, QList<OcrTextBox> *boxes);
+    // 保存当前图片的文本框位置和文本区域窄条，只保留最近一张图片
+    // elapsedMs为这次识别的耗时，切换语言重新识别时用于对比
+    void storeDetection(quint64 digest, const QImage &input, const QString &language, const QList<OcrTextBox> &boxes,
+                        OcrCancelToken *token, qint64 elapsedMs);
+    /*
+    * @bref: recognizeDetected 同一图片切换语言时，只在保存的文本框区域上重新识别
+    * 识别时保存的文本区域窄条重新识别，按区域映射回原来的版面；
+    * 插件没有只识别的接口，窄条上仍会执行检测，节省的是文字区域以外的计算
+    * @param: result 输出识别的文本框，坐标为预处理后的图片坐标
+    * @return: 没有可用的文本框位置时返回false
+    */
+    bool recognizeDetected(quint64 digest, const QString &language, OcrCancelToken *token, QList<OcrTextBox> *result);
+    // 将文本框区域裁剪后纵向拼接为窄条，offsets输出各区域在窄条中的纵坐标；窄条过高时返回空图片
+    QImage buildStrip(const QImage &input, const QList<QRect> &rects, QList<int> *offsets) const;
+    // 图片切分为重叠的分块，使用多个引擎实例并行识别后合并结果，返回的坐标相对于image
+    // partial不为空时，每当一行分块及其之前的分块全部完成，回调这一行分块负责区域内的文本
+    // bytesCopied累加裁剪分块复制的字节数
+    QList<OcrTextBox> analyzeTiles(const QImage &image, const QList<TileLayout::Tile> &tiles, const QString &language,
+                                   OcrCancelToken *token, const OcrPartialResultCallback &partial, qint64 *bytesCopied);
+    // 识别图片并返回各文本框的位置和文本
+    QList<OcrTextBox> analyzeBoxes(Dtk::Ocr::DOcr *driver, const QImage &image);
+
+    std::atomic_int m_runningCount {0};
     QSettings *ocrSetting;
     bool m_isV5 {false};
+    bool m_useVulkan {false};
+    QString m_pluginName;
+    ResultCache *m_resultCache {nullptr};
+    DiskResultCache *m_diskCache {nullptr};
+    FrameHistory *m_frameHistory {nullptr};           // 未启用画面去重时为空
+    QThreadPool *m_tilePool {nullptr};
+    int m_tileSize {0};
+    int m_tileOverlap {0};
+    int m_targetTextHeight {0};
+    bool m_autoOrientation {false};
+
+    int m_maxPoolSize {1};                            // 同时识别的实例个数上限
+    int m_driverLimit {1};                            // 已创建实例的个数上限
+    int m_creatingCount {0};                          // 正在创建的实例个数
+    std::atomic_int m_threadCount {0};               // 配置的线程数，0表示自动
+    int m_inferenceCpus {1};                          // 用于推理的CPU个数，初始化时计算一次
+    mutable QMutex m_poolMutex;
+    QWaitCondition m_poolCondition;
+    QList<Dtk::Ocr::DOcr *> m_drivers;              // 已创建的全部实例
+    QList<Dtk::Ocr::DOcr *> m_idleDrivers;          // 空闲实例，按最近归还的顺序排在末尾
+    QHash<Dtk::Ocr::DOcr *, QString> m_driverLanguage; // 各实例当前加载的语言
+    QHash<Dtk::Ocr::DOcr *, int> m_driverThreads;     // 各实例当前使用的线程数
+    QString m_language;
+
+    // 最近一次识别的文本框区域，坐标为预处理后的图片坐标
+    struct Detection {
+        quint64 digest {0};
+        QString language;
+        QImage strip;       // 文本框区域拼成的窄条，不保存整张图片
+        QList<QRect> rects;
+        QList<int> offsets; // 各区域在窄条中的纵坐标
+        qint64 elapsedMs {0}; // 整图识别的耗时
+    };
+    QMutex m_detectionMutex;
+    Detection m_detection;
 };
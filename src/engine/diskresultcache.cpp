@@ -0,0 +1,254 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "diskresultcache.h"
+#include "imagehash.h"
+#include "util/log.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <cstring>
+
+#include <sys/mman.h>
+
+// 文件头: 8字节标识 + 8字节模型标识
+static const QByteArray kFileMagic("DOCRRC02");
+static constexpr qint64 kFileHeaderSize = 16;
+static constexpr quint32 kRecordMagic = 0x52434f44;
+
+DiskResultCache::DiskResultCache(const QString &filePath, qint64 maxBytes, quint64 modelId)
+    : m_filePath(filePath)
+    , m_maxBytes(maxBytes)
+    , m_modelId(modelId)
+{
+    if (m_maxBytes > 0 && !open()) {
+        qCWarning(dmOcr) << "Failed to open result cache file:" << m_filePath;
+    }
+}
+
+DiskResultCache::~DiskResultCache()
+{
+    close();
+}
+
+bool DiskResultCache::open()
+{
+    QDir().mkpath(QFileInfo(m_filePath).absolutePath());
+    m_file.setFileName(m_filePath);
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        return false;
+    }
+
+    //文件头不匹配(新文件、格式变化或模型变化)时清空重建
+    const QByteArray header = m_file.read(kFileHeaderSize);
+    quint64 modelId = 0;
+    if (header.size() == kFileHeaderSize) {
+        memcpy(&modelId, header.constData() + kFileMagic.size(), sizeof(modelId));
+    }
+    if (header.size() < kFileHeaderSize || !header.startsWith(kFileMagic) || modelId != m_modelId) {
+        if (header.startsWith(kFileMagic)) {
+            qCInfo(dmOcr) << "Recognition model changed, clearing result cache file";
+        }
+        if (!reset()) {
+            m_file.close();
+            return false;
+        }
+    }
+
+    //映射按大小上限一次建立，追加的记录都在映射范围内，不需要重新映射；
+    //文件末尾之后的部分不会被访问
+    const qint64 fileSize = m_file.size();
+    m_mappedSize = qMax(fileSize, m_maxBytes);
+    void *address = mmap(nullptr, static_cast<size_t>(m_mappedSize), PROT_READ, MAP_SHARED, m_file.handle(), 0);
+    if (address == MAP_FAILED) {
+        m_file.close();
+        return false;
+    }
+    m_data = static_cast<const uchar *>(address);
+
+    //上次退出时写入不完整的记录直接截掉
+    m_end = buildIndex(fileSize);
+    if (m_end < fileSize) {
+        qCWarning(dmOcr) << "Result cache file truncated from" << fileSize << "to" << m_end;
+        m_file.resize(m_end);
+    }
+    qCInfo(dmOcr) << "Result cache file loaded:" << m_filePath << "entries:" << m_index.size() << "size:" << m_end;
+    return true;
+}
+
+void DiskResultCache::close()
+{
+    if (m_data) {
+        munmap(const_cast<uchar *>(m_data), static_cast<size_t>(m_mappedSize));
+        m_data = nullptr;
+    }
+    m_mappedSize = 0;
+    m_end = 0;
+    m_index.clear();
+    m_file.close();
+}
+
+bool DiskResultCache::reset()
+{
+    if (!m_file.resize(0) || !m_file.seek(0)) {
+        return false;
+    }
+    QByteArray header = kFileMagic;
+    header.append(reinterpret_cast<const char *>(&m_modelId), sizeof(m_modelId));
+    return m_file.write(header) == kFileHeaderSize && m_file.flush();
+}
+
+qint64 DiskResultCache::buildIndex(qint64 fileSize)
+{
+    m_index.clear();
+    qint64 pos = kFileHeaderSize;
+    while (pos + static_cast<qint64>(sizeof(RecordHeader)) <= fileSize) {
+        RecordHeader header;
+        memcpy(&header, m_data + pos, sizeof(header));
+        if (header.magic != kRecordMagic) {
+            break;
+        }
+        qint64 payloadSize = static_cast<qint64>(header.keySize) + header.valueSize;
+        qint64 end = pos + static_cast<qint64>(sizeof(RecordHeader)) + payloadSize;
+        if (end > fileSize) {
+            break;
+        }
+        const char *payload = reinterpret_cast<const char *>(m_data + pos + sizeof(RecordHeader));
+        if (ImageHash::hash(payload, payloadSize) != header.checksum) {
+            break;
+        }
+        //同一个键以最后写入的记录为准
+        m_index.insert(QByteArray(payload, static_cast<int>(header.keySize)), pos);
+        pos = end;
+    }
+    return pos;
+}
+
+bool DiskResultCache::find(const QString &key, QString *result)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_data) {
+        return false;
+    }
+
+    const QByteArray keyData = key.toUtf8();
+    auto it = m_index.constFind(keyData);
+    if (it == m_index.constEnd()) {
+        return false;
+    }
+
+    const qint64 offset = it.value();
+    RecordHeader header;
+    memcpy(&header, m_data + offset, sizeof(header));
+    const char *value = reinterpret_cast<const char *>(m_data + offset + sizeof(RecordHeader) + header.keySize);
+    //append可能触发压缩并重新映射文件，先复制出结果
+    QByteArray valueData(value, static_cast<int>(header.valueSize));
+    *result = QString::fromUtf8(valueData);
+
+    //位于文件前半部分的记录在压缩时会被淘汰，命中后重新追加到末尾
+    if (offset < kFileHeaderSize + (m_end - kFileHeaderSize) / 2) {
+        append(keyData, valueData);
+    }
+    return true;
+}
+
+void DiskResultCache::insert(const QString &key, const QString &result)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_data) {
+        return;
+    }
+    append(key.toUtf8(), result.toUtf8());
+}
+
+bool DiskResultCache::append(const QByteArray &key, const QByteArray &value)
+{
+    const qint64 recordSize = static_cast<qint64>(sizeof(RecordHeader)) + key.size() + value.size();
+    if (recordSize > m_maxBytes / 2) {
+        return false;
+    }
+    if (m_end + recordSize > m_maxBytes && !compact()) {
+        //压缩失败时文件仍超出映射范围，继续追加的记录无法通过映射读取，停用缓存
+        qCWarning(dmOcr) << "Disabling result cache after failed compaction";
+        close();
+        return false;
+    }
+    if (m_end + recordSize > m_mappedSize) {
+        return false;
+    }
+
+    //记录头和内容一次写入
+    QByteArray record(static_cast<int>(sizeof(RecordHeader)), '\0');
+    record.append(key);
+    record.append(value);
+    RecordHeader header;
+    header.magic = kRecordMagic;
+    header.keySize = static_cast<quint32>(key.size());
+    header.valueSize = static_cast<quint32>(value.size());
+    header.reserved = 0;
+    header.checksum = ImageHash::hash(record.constData() + sizeof(RecordHeader), key.size() + value.size());
+    memcpy(record.data(), &header, sizeof(header));
+
+    //只追加写入，MAP_SHARED映射与文件共享页缓存，写入后即可通过已有映射读取
+    const qint64 offset = m_end;
+    if (!m_file.seek(offset) || m_file.write(record) != record.size() || !m_file.flush()) {
+        qCWarning(dmOcr) << "Failed to write result cache record:" << m_file.errorString();
+        m_file.resize(offset);
+        return false;
+    }
+    m_end = offset + recordSize;
+    m_index.insert(key, offset);
+    return true;
+}
+
+bool DiskResultCache::compact()
+{
+    //从最新的记录开始保留，总大小不超过上限的一半
+    QList<qint64> offsets = m_index.values();
+    std::sort(offsets.begin(), offsets.end());
+    const qint64 keepBytes = m_maxBytes / 2;
+    qint64 keptSize = 0;
+    int first = offsets.size();
+    while (first > 0) {
+        RecordHeader header;
+        memcpy(&header, m_data + offsets.at(first - 1), sizeof(header));
+        qint64 recordSize = static_cast<qint64>(sizeof(RecordHeader)) + header.keySize + header.valueSize;
+        if (keptSize + recordSize > keepBytes) {
+            break;
+        }
+        keptSize += recordSize;
+        --first;
+    }
+
+    QSaveFile saveFile(m_filePath);
+    bool written = saveFile.open(QIODevice::WriteOnly);
+    if (written) {
+        written = saveFile.write(kFileMagic) == kFileMagic.size()
+                  && saveFile.write(reinterpret_cast<const char *>(&m_modelId), sizeof(m_modelId)) == static_cast<qint64>(sizeof(m_modelId));
+        for (int i = first; written && i < offsets.size(); ++i) {
+            RecordHeader header;
+            memcpy(&header, m_data + offsets.at(i), sizeof(header));
+            qint64 recordSize = static_cast<qint64>(sizeof(RecordHeader)) + header.keySize + header.valueSize;
+            written = saveFile.write(reinterpret_cast<const char *>(m_data + offsets.at(i)), recordSize) == recordSize;
+        }
+    }
+
+    const int total = offsets.size();
+    close();
+    if (!written || !saveFile.commit()) {
+        qCWarning(dmOcr) << "Failed to compact result cache file:" << saveFile.errorString();
+        return false;
+    }
+    qCInfo(dmOcr) << "Result cache compacted, kept" << total - first << "of" << total << "entries";
+
+    if (!open()) {
+        qCWarning(dmOcr) << "Failed to reopen result cache file:" << m_filePath;
+        return false;
+    }
+    return true;
+}
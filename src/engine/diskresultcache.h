@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DISKRESULTCACHE_H
+#define DISKRESULTCACHE_H
+
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+/*
+ * @bref: DiskResultCache 持久化的识别结果缓存
+ * 记录只追加写入文件，读取时通过内存映射访问；启动时扫描文件建立键到偏移的索引
+ * 映射按大小上限一次建立，追加记录不需要重新映射；文件超过大小上限时按写入先后淘汰旧记录，
+ * 命中的旧记录会重新追加以延长保留时间
+ * 文件头记录识别模型的标识，模型变化(插件升级)后旧结果全部作废
+*/
+class DiskResultCache
+{
+public:
+    /*
+    * @param: filePath 缓存文件路径
+    * @param: maxBytes 文件大小上限，不大于0时不使用缓存
+    * @param: modelId 识别模型的标识，与文件中记录的不一致时清空缓存
+    */
+    DiskResultCache(const QString &filePath, qint64 maxBytes, quint64 modelId);
+    ~DiskResultCache();
+
+    bool isEnabled() const
+    {
+        return m_data != nullptr;
+    }
+
+    // 查找结果，命中时写入result并返回true
+    bool find(const QString &key, QString *result);
+    void insert(const QString &key, const QString &result);
+
+    // 有效记录占用的文件大小
+    qint64 size() const
+    {
+        return m_end;
+    }
+
+private:
+    struct RecordHeader {
+        quint32 magic;
+        quint32 keySize;    // 键的UTF-8字节数
+        quint32 valueSize;  // 结果的UTF-8字节数
+        quint32 reserved;
+        quint64 checksum;   // 键和结果的哈希，用于识别写入不完整的记录
+    };
+
+    bool open();
+    void close();
+    // 写入文件头，清空已有记录
+    bool reset();
+    // 扫描文件建立索引，返回最后一条完整记录的结束位置
+    qint64 buildIndex(qint64 fileSize);
+    bool append(const QByteArray &key, const QByteArray &value);
+    // 保留较新的记录重写文件，失败时缓存已关闭，返回false
+    bool compact();
+
+    QString m_filePath;
+    qint64 m_maxBytes {0};
+    quint64 m_modelId {0};
+    QMutex m_mutex;
+    QFile m_file;
+    const uchar *m_data {nullptr};
+    qint64 m_mappedSize {0};            // 映射的大小，不小于文件大小上限
+    qint64 m_end {0};                   // 最后一条记录的结束位置，新记录从这里追加
+    QHash<QByteArray, qint64> m_index;  // 键到记录偏移的映射
+};
+
+#endif // DISKRESULTCACHE_H
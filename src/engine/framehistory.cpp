@@ -0,0 +1,154 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "framehistory.h"
+#include "util/log.h"
+
+#include <QtAlgorithms>
+#include <QMutexLocker>
+
+// 亮度网格的边长(原图像素)
+static constexpr int kCellSize = 16;
+// dHash不同的位数不超过该值时视为相似画面
+static constexpr int kMaxHashDistance = 6;
+// 像素亮度的变化超过该值时视为有变化，忽略压缩噪点；按像素比较，一个小数点的变化也不会被平均掉
+static constexpr int kPixelThreshold = 24;
+// 变化区域向外扩展的像素，保证文字笔画完整
+static constexpr int kChangedMargin = kCellSize;
+// 变化区域超过画面的该比例时完整识别
+static constexpr qreal kMaxChangedRatio = 0.3;
+
+FrameHistory::FrameHistory(int capacity)
+    : m_capacity(capacity)
+{
+}
+
+FrameHistory::Signature FrameHistory::signature(const QImage &image)
+{
+    Signature frame;
+    if (image.isNull()) {
+        return frame;
+    }
+    frame.size = image.size();
+    frame.gray = image.convertToFormat(QImage::Format_Grayscale8);
+
+    //dHash: 缩小到9x8，比较每行相邻像素的亮度
+    const QImage thumbnail = frame.gray.scaled(9, 8, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    for (int y = 0; y < 8; ++y) {
+        const uchar *line = thumbnail.constScanLine(y);
+        for (int x = 0; x < 8; ++x) {
+            frame.hash = (frame.hash << 1) | (line[x] > line[x + 1] ? 1 : 0);
+        }
+    }
+    return frame;
+}
+
+QRect FrameHistory::changedRegion(const Signature &previous, const Signature &current)
+{
+    //按网格记录是否有像素变化，一个网格只需找到一个变化的像素
+    const int columns = (current.size.width() + kCellSize - 1) / kCellSize;
+    QRect changed;
+    for (int y = 0; y < current.gray.height(); ++y) {
+        const uchar *before = previous.gray.constScanLine(y);
+        const uchar *after = current.gray.constScanLine(y);
+        const int cellY = y / kCellSize;
+        for (int cellX = 0; cellX < columns; ++cellX) {
+            const QRect cell(cellX * kCellSize, cellY * kCellSize, kCellSize, kCellSize);
+            if (changed.contains(cell)) {
+                continue;
+            }
+            const int end = qMin(current.gray.width(), (cellX + 1) * kCellSize);
+            for (int x = cellX * kCellSize; x < end; ++x) {
+                if (qAbs(before[x] - after[x]) > kPixelThreshold) {
+                    changed |= cell;
+                    break;
+                }
+            }
+        }
+    }
+    if (changed.isEmpty()) {
+        return changed;
+    }
+    return changed.adjusted(-kChangedMargin, -kChangedMargin, kChangedMargin, kChangedMargin)
+        .intersected(QRect(QPoint(0, 0), current.size));
+}
+
+FrameHistory::Match FrameHistory::match(const Signature &frame, const QString &language, QString *text,
+                                        QList<OcrTextBox> *boxes, QRect *changed)
+{
+    QMutexLocker locker(&m_mutex);
+    for (int i = 0; i < m_entries.size(); ++i) {
+        const Entry &entry = m_entries.at(i);
+        if (entry.language != language || entry.frame.size != frame.size
+                || qPopulationCount(entry.frame.hash ^ frame.hash) > kMaxHashDistance) {
+            continue;
+        }
+
+        QRect region = changedRegion(entry.frame, frame);
+        if (region.isEmpty()) {
+            *text = entry.text;
+            m_entries.move(i, 0);
+            qCInfo(dmOcr) << "Frame unchanged since a recent recognition, reusing result";
+            return Unchanged;
+        }
+
+        //与变化区域相交的文本框整体重新识别，避免一行文字被截断
+        bool expanded = true;
+        while (expanded) {
+            expanded = false;
+            for (const OcrTextBox &box : entry.boxes) {
+                const QRect bounds = box.polygon.boundingRect().toAlignedRect();
+                if (bounds.intersects(region) && !region.contains(bounds)) {
+                    region |= bounds;
+                    expanded = true;
+                }
+            }
+        }
+        region = region.intersected(QRect(QPoint(0, 0), frame.size));
+
+        const qreal ratio = static_cast<qreal>(region.width()) * region.height() / (static_cast<qreal>(frame.size.width()) * frame.size.height());
+        if (ratio > kMaxChangedRatio) {
+            qCInfo(dmOcr) << "Frame similar to a recent recognition but changed area too large:" << ratio;
+            return NoMatch;
+        }
+        *text = entry.text;
+        *boxes = entry.boxes;
+        *changed = region;
+        qCInfo(dmOcr) << "Frame changed only in region" << region << "area ratio:" << ratio;
+        return RegionChanged;
+    }
+    return NoMatch;
+}
+
+void FrameHistory::insert(const Signature &frame, const QString &language, const QString &text, const QList<OcrTextBox> &boxes)
+{
+    if (frame.isNull() || m_capacity <= 0) {
+        return;
+    }
+    QMutexLocker locker(&m_mutex);
+    //同一画面只保留最新的结果
+    for (int i = 0; i < m_entries.size(); ++i) {
+        const Entry &entry = m_entries.at(i);
+        if (entry.language == language && entry.frame.size == frame.size && entry.frame.hash == frame.hash) {
+            m_entries.removeAt(i);
+            break;
+        }
+    }
+    m_entries.prepend({frame, language, text, boxes});
+    while (m_entries.size() > m_capacity) {
+        m_entries.removeLast();
+    }
+}
+
+QList<OcrTextBox> FrameHistory::splice(const QList<OcrTextBox> &previous, const QRect &changed, const QList<OcrTextBox> &regionBoxes)
+{
+    QList<OcrTextBox> boxes;
+    for (const OcrTextBox &box : previous) {
+        if (!changed.intersects(box.polygon.boundingRect().toAlignedRect())) {
+            boxes << box;
+        }
+    }
+    boxes << regionBoxes;
+    return boxes;
+}
@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef FRAMEHISTORY_H
+#define FRAMEHISTORY_H
+
+#include "ocrresult.h"
+
+#include <QImage>
+#include <QList>
+#include <QMutex>
+#include <QRect>
+#include <QString>
+
+/*
+ * @bref: FrameHistory 最近识别过的画面，用于连续截图的去重
+ * 用感知哈希(dHash)找出相似的历史画面，再逐像素比较亮度，按网格找出变化的区域：
+ * 没有变化时直接复用结果，只有小块区域变化时只识别该区域并替换其中的文本框
+*/
+class FrameHistory
+{
+public:
+    // 画面特征
+    struct Signature {
+        QSize size;
+        quint64 hash {0};   // dHash，64位
+        QImage gray;        // 原分辨率的亮度，Grayscale8
+
+        bool isNull() const
+        {
+            return gray.isNull();
+        }
+    };
+
+    enum Match {
+        NoMatch = 0,        // 没有相似的画面，需要完整识别
+        Unchanged,          // 画面没有变化，直接复用结果
+        RegionChanged       // 只有部分区域变化，重新识别该区域
+    };
+
+    explicit FrameHistory(int capacity);
+
+    // 计算画面特征，开销与一次灰度转换和缩放相当
+    static Signature signature(const QImage &image);
+
+    /*
+    * @bref: match 查找同一语言下相似的最近画面
+    * @param: text 输出该画面的识别结果
+    * @param: boxes 输出该画面的文本框，原图坐标
+    * @param: changed 输出需要重新识别的区域，已扩展到覆盖与变化区域相交的文本框
+    */
+    Match match(const Signature &frame, const QString &language, QString *text, QList<OcrTextBox> *boxes, QRect *changed);
+
+    // 记录画面及其识别结果，超出容量时淘汰最早的画面
+    void insert(const Signature &frame, const QString &language, const QString &text, const QList<OcrTextBox> &boxes);
+
+    // 用变化区域的识别结果替换历史结果中该区域的文本框
+    static QList<OcrTextBox> splice(const QList<OcrTextBox> &previous, const QRect &changed, const QList<OcrTextBox> &regionBoxes);
+
+private:
+    struct Entry {
+        Signature frame;
+        QString language;
+        QString text;
+        QList<OcrTextBox> boxes;
+    };
+
+    // 两幅画面中亮度变化的网格区域(原图坐标)，没有变化时返回空区域
+    static QRect changedRegion(const Signature &previous, const Signature &current);
+
+    int m_capacity {0};
+    QMutex m_mutex;
+    QList<Entry> m_entries;     // 最近使用的排在前面
+};
+
+#endif // FRAMEHISTORY_H
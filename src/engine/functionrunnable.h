@@ -0,0 +1,32 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef FUNCTIONRUNNABLE_H
+#define FUNCTIONRUNNABLE_H
+
+#include <QRunnable>
+#include <functional>
+
+/*
+ * @bref: FunctionRunnable 将函数对象包装为QRunnable，执行后自动删除
+*/
+class FunctionRunnable : public QRunnable
+{
+public:
+    explicit FunctionRunnable(std::function<void()> func)
+        : m_func(std::move(func))
+    {
+        setAutoDelete(true);
+    }
+
+    void run() override
+    {
+        m_func();
+    }
+
+private:
+    std::function<void()> m_func;
+};
+
+#endif // FUNCTIONRUNNABLE_H
@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "imagehash.h"
+
+#include <QImage>
+#include <cstring>
+
+namespace {
+// xxHash64使用的素数，按相同的轮函数并行处理4路数据
+constexpr quint64 kPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr quint64 kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr quint64 kPrime3 = 0x165667B19E3779F9ULL;
+constexpr quint64 kPrime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr quint64 kPrime5 = 0x27D4EB2F165667C5ULL;
+
+inline quint64 rotl(quint64 x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+inline quint64 round(quint64 acc, quint64 input)
+{
+    acc += input * kPrime2;
+    acc = rotl(acc, 31);
+    return acc * kPrime1;
+}
+
+inline quint64 mergeRound(quint64 acc, quint64 value)
+{
+    acc ^= round(0, value);
+    return acc * kPrime1 + kPrime4;
+}
+
+inline quint64 read64(const uchar *p)
+{
+    quint64 value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+quint64 hashBytes(const uchar *data, qsizetype len, quint64 seed)
+{
+    const uchar *p = data;
+    const uchar *end = data + len;
+    quint64 h;
+
+    if (len >= 32) {
+        quint64 v1 = seed + kPrime1 + kPrime2;
+        quint64 v2 = seed + kPrime2;
+        quint64 v3 = seed;
+        quint64 v4 = seed - kPrime1;
+        const uchar *limit = end - 32;
+        do {
+            v1 = round(v1, read64(p));
+            v2 = round(v2, read64(p + 8));
+            v3 = round(v3, read64(p + 16));
+            v4 = round(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = mergeRound(h, v1);
+        h = mergeRound(h, v2);
+        h = mergeRound(h, v3);
+        h = mergeRound(h, v4);
+    } else {
+        h = seed + kPrime5;
+    }
+
+    h += static_cast<quint64>(len);
+    for (; p + 8 <= end; p += 8) {
+        h ^= round(0, read64(p));
+        h = rotl(h, 27) * kPrime1 + kPrime4;
+    }
+    for (; p < end; ++p) {
+        h ^= (*p) * kPrime5;
+        h = rotl(h, 11) * kPrime1;
+    }
+
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+}
+}
+
+quint64 ImageHash::hash(const void *data, qsizetype len, quint64 seed)
+{
+    return hashBytes(static_cast<const uchar *>(data), len, seed);
+}
+
+quint64 ImageHash::digest(const QImage &image)
+{
+    if (image.isNull()) {
+        return 0;
+    }
+
+    //尺寸和像素格式参与计算，相同字节不同格式的图片摘要不同
+    quint64 h = hashBytes(nullptr, 0, (static_cast<quint64>(image.width()) << 32)
+                          ^ (static_cast<quint64>(image.height()) << 8)
+                          ^ static_cast<quint64>(image.format()));
+    const qsizetype lineBytes = (static_cast<qsizetype>(image.width()) * image.depth() + 7) / 8;
+    for (int y = 0; y < image.height(); ++y) {
+        h = hashBytes(image.constScanLine(y), lineBytes, h);
+    }
+    return h;
+}
@@ -0,0 +1,32 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef IMAGEHASH_H
+#define IMAGEHASH_H
+
+#include <QtGlobal>
+
+class QImage;
+
+/*
+ * @bref: ImageHash 图片内容的哈希计算
+*/
+class ImageHash
+{
+public:
+    /*
+    * @bref: digest 计算图片像素数据的64位摘要
+    * 只计算每行的有效像素，忽略行尾对齐填充；结果与进程无关，可用于持久化
+    * @return: 摘要值，空图片返回0
+    */
+    static quint64 digest(const QImage &image);
+
+    // 计算任意数据的64位哈希，seed可用于串联多段数据
+    static quint64 hash(const void *data, qsizetype len, quint64 seed = 0);
+
+private:
+    ImageHash() = delete;
+};
+
+#endif // IMAGEHASH_H
@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "imageingest.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define OCR_INGEST_SSSE3
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define OCR_INGEST_NEON
+#endif
+
+namespace {
+using RowConverter = void (*)(const quint32 *src, uchar *dst, int width);
+
+// 逐像素转换，与字节序无关
+void convertRowScalar(const quint32 *src, uchar *dst, int width)
+{
+    for (int x = 0; x < width; ++x) {
+        const QRgb pixel = src[x];
+        dst[0] = static_cast<uchar>(qRed(pixel));
+        dst[1] = static_cast<uchar>(qGreen(pixel));
+        dst[2] = static_cast<uchar>(qBlue(pixel));
+        dst += 3;
+    }
+}
+
+#if defined(OCR_INGEST_SSSE3)
+// 小端内存中像素为BGRA，每次读入4个像素重排为12字节RGB
+__attribute__((target("ssse3"))) void convertRowSsse3(const quint32 *src, uchar *dst, int width)
+{
+    const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    int x = 0;
+    //每次写入16字节，保证最后一次写入不越过行尾
+    for (; x + 6 <= width; x += 4) {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 3), _mm_shuffle_epi8(pixels, shuffle));
+    }
+    convertRowScalar(src + x, dst + x * 3, width - x);
+}
+#endif
+
+#if defined(OCR_INGEST_NEON)
+// 解交织读入BGRA四个通道，按RGB顺序交织写出
+void convertRowNeon(const quint32 *src, uchar *dst, int width)
+{
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        uint8x16x4_t bgra = vld4q_u8(reinterpret_cast<const uint8_t *>(src + x));
+        uint8x16x3_t rgb;
+        rgb.val[0] = bgra.val[2];
+        rgb.val[1] = bgra.val[1];
+        rgb.val[2] = bgra.val[0];
+        vst3q_u8(dst + x * 3, rgb);
+    }
+    convertRowScalar(src + x, dst + x * 3, width - x);
+}
+#endif
+
+struct BestConverter {
+    RowConverter convert;
+    const char *name;
+};
+
+BestConverter selectRowConverter()
+{
+#if defined(OCR_INGEST_SSSE3)
+    if (__builtin_cpu_supports("ssse3")) {
+        return {convertRowSsse3, "ssse3"};
+    }
+#elif defined(OCR_INGEST_NEON)
+    return {convertRowNeon, "neon"};
+#endif
+    return {convertRowScalar, "scalar"};
+}
+
+// 首次使用时按CPU特性选择
+const BestConverter &bestConverter()
+{
+    static const BestConverter converter = selectRowConverter();
+    return converter;
+}
+
+// 32位且不带预乘的格式可以直接丢弃alpha转换
+bool isDirect32(QImage::Format format)
+{
+    return format == QImage::Format_RGB32 || format == QImage::Format_ARGB32;
+}
+}
+
+const char *ImageIngest::bestKernelName()
+{
+    return bestConverter().name;
+}
+
+QImage ImageIngest::toDriverFormat(const QImage &image, qint64 *bytesCopied, Kernel kernel)
+{
+    if (image.isNull() || image.format() == DriverFormat) {
+        return image;
+    }
+
+    QImage result;
+    if (isDirect32(image.format())) {
+        const RowConverter convertRow = kernel == ScalarKernel ? convertRowScalar : bestConverter().convert;
+        result = QImage(image.size(), DriverFormat);
+        if (result.isNull()) {
+            return result;
+        }
+        const int height = image.height();
+        for (int y = 0; y < height; ++y) {
+            convertRow(reinterpret_cast<const quint32 *>(image.constScanLine(y)), result.scanLine(y), image.width());
+        }
+    } else {
+        result = image.convertToFormat(DriverFormat);
+    }
+    //转换会丢失分辨率信息，保持与原图一致
+    result.setDotsPerMeterX(image.dotsPerMeterX());
+    result.setDotsPerMeterY(image.dotsPerMeterY());
+
+    if (bytesCopied) {
+        *bytesCopied += result.sizeInBytes();
+    }
+    return result;
+}
@@ -0,0 +1,41 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef IMAGEINGEST_H
+#define IMAGEINGEST_H
+
+#include <QImage>
+
+/*
+ * @bref: ImageIngest 将输入图片转换为识别插件直接使用的像素格式
+ * 插件内部按RGB888处理，已是该格式的图片共享像素数据不做复制；
+ * 32位格式使用SIMD转换，其余格式交给Qt转换，每张图片最多转换一次
+*/
+class ImageIngest
+{
+public:
+    // 插件直接使用的像素格式
+    static constexpr QImage::Format DriverFormat = QImage::Format_RGB888;
+
+    // 32位格式的行转换实现，测试和性能对比时可指定使用逐像素转换
+    enum Kernel {
+        BestKernel = 0,     // 当前CPU支持的最快实现(SSSE3/NEON)
+        ScalarKernel        // 逐像素转换
+    };
+
+    /*
+    * @bref: toDriverFormat 转换为插件格式
+    * @param: bytesCopied 不为空时累加本次写入的像素字节数，未复制时不变
+    * @param: kernel 32位格式使用的行转换实现
+    */
+    static QImage toDriverFormat(const QImage &image, qint64 *bytesCopied = nullptr, Kernel kernel = BestKernel);
+
+    // BestKernel在当前CPU上实际使用的实现名称
+    static const char *bestKernelName();
+
+private:
+    ImageIngest() = delete;
+};
+
+#endif // IMAGEINGEST_H
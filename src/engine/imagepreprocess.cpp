@@ -0,0 +1,347 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "imagepreprocess.h"
+#include "util/log.h"
+
+#include <QVector>
+#include <QPair>
+#include <QTransform>
+#include <QtMath>
+
+#include <algorithm>
+
+// 估计行高时分析图的最大边长
+static constexpr int kAnalysisSize = 1024;
+// 一行中墨迹像素超过该比例时视为文字行
+static constexpr qreal kTextRowRatio = 0.01;
+// 分析图中小于该高度的行视为噪点
+static constexpr int kMinRunHeight = 2;
+// 行高与目标值之比在该范围内时不缩放
+static constexpr qreal kMinScaleToApply = 0.75;
+static constexpr qreal kMaxScaleToApply = 1.5;
+// 缩放比例和缩放后尺寸的限制
+static constexpr qreal kMinScale = 0.25;
+static constexpr qreal kMaxScale = 4.0;
+static constexpr int kMaxOutputSide = 8192;
+static constexpr int kMinOutputSide = 320;
+// 列投影起伏超过行投影的该倍数时视为文字行竖直
+static constexpr qreal kLineVariationRatio = 1.5;
+// 升部与降部墨迹之比超过该值时才确定方向
+static constexpr qreal kExtentRatio = 1.3;
+// 判断倒置时要求的升降部之比，方块字上下墨迹大致对称，达不到该值
+static constexpr qreal kFlipExtentRatio = 2.5;
+// 主体上下的墨迹占文字行墨迹的比例低于该值时视为没有升降部(如纯中文)，不判断方向
+static constexpr qreal kMinExtentShare = 0.1;
+// 分析图中低于该高度的行无法区分升降部
+static constexpr int kMinExtentLineHeight = 6;
+// 大图估计行高时每个方向取样的原分辨率窗口数
+static constexpr int kSampleGrid = 3;
+
+namespace {
+// Otsu法计算二值化阈值
+int otsuThreshold(const QVector<int> &histogram, int total)
+{
+    qint64 sum = 0;
+    for (int i = 0; i < 256; ++i) {
+        sum += static_cast<qint64>(i) * histogram.at(i);
+    }
+
+    qint64 sumBackground = 0;
+    int weightBackground = 0;
+    double maxVariance = 0;
+    int threshold = 128;
+    for (int i = 0; i < 256; ++i) {
+        weightBackground += histogram.at(i);
+        if (weightBackground == 0) {
+            continue;
+        }
+        int weightForeground = total - weightBackground;
+        if (weightForeground == 0) {
+            break;
+        }
+        sumBackground += static_cast<qint64>(i) * histogram.at(i);
+        double meanBackground = static_cast<double>(sumBackground) / weightBackground;
+        double meanForeground = static_cast<double>(sum - sumBackground) / weightForeground;
+        double variance = static_cast<double>(weightBackground) * weightForeground
+                          * (meanBackground - meanForeground) * (meanBackground - meanForeground);
+        if (variance > maxVariance) {
+            maxVariance = variance;
+            threshold = i;
+        }
+    }
+    return threshold;
+}
+
+// 在缩小的灰度图上用Otsu法二值化，墨迹像素为1，其余为0
+QImage inkMask(const QImage &image)
+{
+    if (image.isNull()) {
+        return QImage();
+    }
+    const qreal factor = qMin<qreal>(1.0, static_cast<qreal>(kAnalysisSize) / qMax(image.width(), image.height()));
+    QImage gray = factor < 1.0 ? image.scaled(image.size() * factor, Qt::KeepAspectRatio, Qt::SmoothTransformation) : image;
+    gray = gray.convertToFormat(QImage::Format_Grayscale8);
+    if (gray.width() < 1 || gray.height() < 1) {
+        return QImage();
+    }
+
+    QVector<int> histogram(256, 0);
+    for (int y = 0; y < gray.height(); ++y) {
+        const uchar *line = gray.constScanLine(y);
+        for (int x = 0; x < gray.width(); ++x) {
+            ++histogram[line[x]];
+        }
+    }
+    const int total = gray.width() * gray.height();
+    const int threshold = otsuThreshold(histogram, total);
+
+    //像素较少的一类视为文字(墨迹)，兼容深色背景浅色文字
+    int darkCount = 0;
+    for (int i = 0; i <= threshold; ++i) {
+        darkCount += histogram.at(i);
+    }
+    const bool darkText = darkCount <= total - darkCount;
+
+    for (int y = 0; y < gray.height(); ++y) {
+        uchar *line = gray.scanLine(y);
+        for (int x = 0; x < gray.width(); ++x) {
+            bool dark = line[x] <= threshold;
+            line[x] = dark == darkText ? 1 : 0;
+        }
+    }
+    return gray;
+}
+
+// 每一行的墨迹像素个数
+QVector<int> rowProfile(const QImage &mask)
+{
+    QVector<int> profile(mask.height(), 0);
+    for (int y = 0; y < mask.height(); ++y) {
+        const uchar *line = mask.constScanLine(y);
+        int ink = 0;
+        for (int x = 0; x < mask.width(); ++x) {
+            ink += line[x];
+        }
+        profile[y] = ink;
+    }
+    return profile;
+}
+
+// 投影中墨迹不少于minInk的连续区间(起点，长度)，过短的区间视为噪点
+QList<QPair<int, int>> inkRuns(const QVector<int> &profile, int minInk)
+{
+    QList<QPair<int, int>> runs;
+    int runStart = 0;
+    int runLength = 0;
+    for (int i = 0; i <= profile.size(); ++i) {
+        if (i < profile.size() && profile.at(i) >= minInk) {
+            if (runLength == 0) {
+                runStart = i;
+            }
+            ++runLength;
+        } else if (runLength > 0) {
+            if (runLength >= kMinRunHeight) {
+                runs << qMakePair(runStart, runLength);
+            }
+            runLength = 0;
+        }
+    }
+    return runs;
+}
+
+// 投影的变异系数平方(方差/均值的平方)，起伏越大值越大
+qreal variation(const QVector<int> &profile)
+{
+    if (profile.isEmpty()) {
+        return 0;
+    }
+    qreal mean = 0;
+    for (int value : profile) {
+        mean += value;
+    }
+    mean /= profile.size();
+    if (mean <= 0) {
+        return 0;
+    }
+    qreal variance = 0;
+    for (int value : profile) {
+        variance += (value - mean) * (value - mean);
+    }
+    variance /= profile.size();
+    return variance / (mean * mean);
+}
+
+// 统计各文字行主体(x高度)上方和下方的墨迹，拉丁文字的升部(b,d,h,大写字母)明显多于降部(g,p,y)
+// total输出参与统计的文字行的墨迹总数
+void lineExtents(const QVector<int> &profile, int width, int *ascender, int *descender, int *total)
+{
+    const int minInk = qMax(1, static_cast<int>(width * kTextRowRatio));
+    for (const auto &run : inkRuns(profile, minInk)) {
+        if (run.second < kMinExtentLineHeight) {
+            continue;
+        }
+        const int end = run.first + run.second;
+        int peak = 0;
+        for (int y = run.first; y < end; ++y) {
+            peak = qMax(peak, profile.at(y));
+            *total += profile.at(y);
+        }
+        //墨迹达到峰值一半的行为文字主体
+        int coreTop = end;
+        int coreBottom = run.first;
+        for (int y = run.first; y < end; ++y) {
+            if (profile.at(y) * 2 >= peak) {
+                coreTop = qMin(coreTop, y);
+                coreBottom = y;
+            }
+        }
+        for (int y = run.first; y < coreTop; ++y) {
+            *ascender += profile.at(y);
+        }
+        for (int y = coreBottom + 1; y < end; ++y) {
+            *descender += profile.at(y);
+        }
+    }
+}
+}
+
+QList<ImagePreprocess::TextRow> ImagePreprocess::textRows(const QImage &image)
+{
+    QList<TextRow> rows;
+    const QImage mask = inkMask(image);
+    if (mask.isNull()) {
+        return rows;
+    }
+
+    //水平投影，连续的文字行组成一行文本
+    const QVector<int> profile = rowProfile(mask);
+    const int minInk = qMax(1, static_cast<int>(mask.width() * kTextRowRatio));
+    const qreal toSource = static_cast<qreal>(image.height()) / mask.height();
+    for (const auto &run : inkRuns(profile, minInk)) {
+        int runInk = 0;
+        for (int y = run.first; y < run.first + run.second; ++y) {
+            runInk += profile.at(y);
+        }
+        TextRow row;
+        row.top = qFloor(run.first * toSource);
+        row.height = qMax(1, qCeil(run.second * toSource));
+        row.inkRatio = static_cast<qreal>(runInk) / (run.second * mask.width());
+        rows << row;
+    }
+    return rows;
+}
+
+int ImagePreprocess::detectOrientation(const QImage &image)
+{
+    const QImage mask = inkMask(image);
+    if (mask.isNull()) {
+        return 0;
+    }
+
+    //文字行水平时行投影起伏大(行与行间距交替)，列投影较平坦；竖排时相反
+    const QVector<int> rows = rowProfile(mask);
+    const QVector<int> columns = rowProfile(mask.transformed(QTransform().rotate(90)));
+    const qreal rowVariation = variation(rows);
+    const qreal columnVariation = variation(columns);
+
+    int orientation = 0;
+    int ascender = 0;
+    int descender = 0;
+    int total = 0;
+    if (rowVariation >= columnVariation) {
+        lineExtents(rows, mask.width(), &ascender, &descender, &total);
+        //升部多于降部为正向，反之为倒置
+        //中文行的墨迹上下大致对称，只是笔画分布带来的差异，要求更大的比值才判为倒置，误判会把正向的页面转反
+        if ((ascender + descender) >= total * kMinExtentShare && descender > ascender * kFlipExtentRatio) {
+            orientation = 180;
+        }
+    } else if (columnVariation > rowVariation * kLineVariationRatio) {
+        //顺时针旋转90度后文字行变为水平，再按升降部判断方向
+        //没有明显的升降部差异时(如纯中文)不旋转，避免把竖排文字转成横排
+        lineExtents(columns, mask.height(), &ascender, &descender, &total);
+        if ((ascender + descender) >= total * kMinExtentShare) {
+            if (ascender > descender * kExtentRatio) {
+                orientation = 90;
+            } else if (descender > ascender * kExtentRatio) {
+                orientation = 270;
+            }
+        }
+    }
+    qCInfo(dmOcr) << "Orientation detected:" << orientation << "row variation:" << rowVariation
+                  << "column variation:" << columnVariation << "ascender:" << ascender << "descender:" << descender << "total:" << total;
+    return orientation;
+}
+
+int ImagePreprocess::estimateTextHeight(const QImage &image)
+{
+    if (image.isNull()) {
+        return 0;
+    }
+
+    QVector<int> heights;
+    if (qMax(image.width(), image.height()) <= kAnalysisSize) {
+        for (const TextRow &row : textRows(image)) {
+            heights << row.height;
+        }
+    } else {
+        //大图缩小到分析尺寸后相邻的文字行会粘连，行高被高估；在原分辨率的若干窗口中测量
+        const QSize window(qMin(image.width(), kAnalysisSize), qMin(image.height(), kAnalysisSize));
+        const int columns = image.width() > window.width() ? kSampleGrid : 1;
+        const int rows = image.height() > window.height() ? kSampleGrid : 1;
+        for (int gy = 0; gy < rows; ++gy) {
+            for (int gx = 0; gx < columns; ++gx) {
+                const int x = columns > 1 ? (image.width() - window.width()) * gx / (columns - 1) : 0;
+                const int y = rows > 1 ? (image.height() - window.height()) * gy / (rows - 1) : 0;
+                for (const TextRow &row : textRows(image.copy(QRect(QPoint(x, y), window)))) {
+                    //被窗口上下边缘截断的行高度不准
+                    if (row.top <= 0 || row.top + row.height >= window.height()) {
+                        continue;
+                    }
+                    heights << row.height;
+                }
+            }
+        }
+    }
+    if (heights.isEmpty()) {
+        return 0;
+    }
+
+    std::nth_element(heights.begin(), heights.begin() + heights.size() / 2, heights.end());
+    return heights.at(heights.size() / 2);
+}
+
+QImage ImagePreprocess::normalizeResolution(const QImage &image, int targetTextHeight, qreal *scale)
+{
+    *scale = 1.0;
+    if (targetTextHeight <= 0 || image.isNull()) {
+        return image;
+    }
+
+    const int textHeight = estimateTextHeight(image);
+    if (textHeight <= 0) {
+        return image;
+    }
+
+    qreal factor = static_cast<qreal>(targetTextHeight) / textHeight;
+    if (factor >= kMinScaleToApply && factor <= kMaxScaleToApply) {
+        return image;
+    }
+
+    const bool upscale = factor > 1.0;
+    factor = qBound(kMinScale, factor, kMaxScale);
+    const int longSide = qMax(image.width(), image.height());
+    const int shortSide = qMin(image.width(), image.height());
+    factor = qMin(factor, static_cast<qreal>(kMaxOutputSide) / longSide);
+    factor = qMax(factor, qMin<qreal>(1.0, static_cast<qreal>(kMinOutputSide) / shortSide));
+    //尺寸限制可能把需要的放大变成缩小(或反之)，这时缩放只会让文字离目标行高更远，保持原图
+    if (qFuzzyCompare(factor, 1.0) || (factor > 1.0) != upscale) {
+        return image;
+    }
+
+    QSize size(qMax(1, qRound(image.width() * factor)), qMax(1, qRound(image.height() * factor)));
+    *scale = static_cast<qreal>(size.width()) / image.width();
+    qCInfo(dmOcr) << "Normalizing image resolution, text height:" << textHeight << "scale:" << *scale << "size:" << size;
+    return image.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+}
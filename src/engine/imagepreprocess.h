@@ -0,0 +1,56 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef IMAGEPREPROCESS_H
+#define IMAGEPREPROCESS_H
+
+#include <QImage>
+
+/*
+ * @bref: ImagePreprocess 识别前的图片预处理
+*/
+class ImagePreprocess
+{
+public:
+    // 水平投影得到的一行文本
+    struct TextRow {
+        int top {0};          // 原图坐标
+        int height {0};
+        qreal inkRatio {0};   // 行内墨迹像素的比例
+    };
+
+    /*
+    * @bref: textRows 在缩小的灰度图上二值化后做水平投影，找出文字行
+    * @return: 按从上到下排列的文字行
+    */
+    static QList<TextRow> textRows(const QImage &image);
+
+    /*
+    * @bref: detectOrientation 估计页面方向
+    * 比较缩小的二值图行、列投影的起伏判断文字行是否竖直，
+    * 再比较文字行主体上方(升部)和下方(降部)的墨迹判断正反；依据不足时返回0
+    * @return: 图片需要顺时针旋转的角度(0/90/180/270)
+    */
+    static int detectOrientation(const QImage &image);
+
+    /*
+    * @bref: estimateTextHeight 估计图片中主要文字的行高
+    * 取textRows中文字行高度的中位数；超过分析尺寸的大图在原分辨率的若干窗口中测量，避免缩小后相邻行粘连
+    * @return: 原图坐标下的行高(像素)，无法估计时返回0
+    */
+    static int estimateTextHeight(const QImage &image);
+
+    /*
+    * @bref: normalizeResolution 缩放图片使文字行高接近目标值
+    * 行高已在目标值附近、无法估计或尺寸限制使缩放方向与需要的相反时返回原图
+    * @param: targetTextHeight 目标行高(像素)
+    * @param: scale 输出实际使用的缩放比例，识别结果坐标除以该值即为原图坐标
+    */
+    static QImage normalizeResolution(const QImage &image, int targetTextHeight, qreal *scale);
+
+private:
+    ImagePreprocess() = delete;
+};
+
+#endif // IMAGEPREPROCESS_H
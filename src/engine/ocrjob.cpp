@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "ocrjob.h"
+
+#include <DOcr>
+#include <QFutureWatcher>
+#include <QMutexLocker>
+
+void OcrCancelToken::cancel()
+{
+    m_cancelled = true;
+    QMutexLocker locker(&m_mutex);
+    for (auto driver : m_drivers) {
+        driver->breakAnalyze();
+    }
+}
+
+void OcrCancelToken::attach(Dtk::Ocr::DOcr *driver)
+{
+    QMutexLocker locker(&m_mutex);
+    m_drivers.append(driver);
+}
+
+void OcrCancelToken::detach(Dtk::Ocr::DOcr *driver)
+{
+    //持有锁期间cancel不会再访问实例，实例可以安全地归还给引擎池
+    QMutexLocker locker(&m_mutex);
+    m_drivers.removeOne(driver);
+}
+
+OcrJobHandle OcrJobHandle::create(quint64 id)
+{
+    OcrJobHandle handle;
+    handle.d.reset(new Data);
+    handle.d->id = id;
+    handle.d->future.reportStarted();
+    return handle;
+}
+
+quint64 OcrJobHandle::id() const
+{
+    return d ? d->id : 0;
+}
+
+bool OcrJobHandle::isFinished() const
+{
+    return d ? d->future.isFinished() : true;
+}
+
+bool OcrJobHandle::isCancelled() const
+{
+    return d ? d->token.isCancelled() : false;
+}
+
+QFuture<QString> OcrJobHandle::future() const
+{
+    return d ? d->future.future() : QFuture<QString>();
+}
+
+OcrResult OcrJobHandle::structuredResult() const
+{
+    return d && d->future.isFinished() ? d->structured : OcrResult();
+}
+
+QString OcrJobHandle::error() const
+{
+    return d && d->future.isFinished() ? d->error : QString();
+}
+
+QList<OcrBatchResult> OcrJobHandle::batchResults() const
+{
+    return d && d->future.isFinished() ? d->batch : QList<OcrBatchResult>();
+}
+
+void OcrJobHandle::cancel()
+{
+    if (d) {
+        d->token.cancel();
+    }
+}
+
+void OcrJobHandle::onFinished(QObject *context, const std::function<void(const QString &, bool)> &callback) const
+{
+    if (!d || !context) {
+        return;
+    }
+
+    //watcher属于context，随context一起销毁，销毁后回调不会再触发
+    auto watcher = new QFutureWatcher<QString>(context);
+    auto data = d;
+    QObject::connect(watcher, &QFutureWatcher<QString>::finished, context, [watcher, data, callback]() {
+        bool cancelled = data->token.isCancelled();
+        QString result = cancelled || data->future.resultCount() == 0 ? QString() : watcher->result();
+        watcher->deleteLater();
+        callback(result, cancelled);
+    });
+    watcher->setFuture(d->future.future());
+}
+
+void OcrJobHandle::setStructuredResult(const OcrResult &result) const
+{
+    d->structured = result;
+}
+
+void OcrJobHandle::setBatchResults(const QList<OcrBatchResult> &results) const
+{
+    d->batch = results;
+}
+
+void OcrJobHandle::setError(const QString &error) const
+{
+    d->error = error;
+}
+
+void OcrJobHandle::reportResult(const QString &result) const
+{
+    if (d->token.isCancelled()) {
+        d->future.reportCanceled();
+    } else {
+        d->future.reportResult(result);
+    }
+    d->future.reportFinished();
+}
+
+OcrCancelToken *OcrJobHandle::token() const
+{
+    return &d->token;
+}
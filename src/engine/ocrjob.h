@@ -0,0 +1,108 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef OCRJOB_H
+#define OCRJOB_H
+
+#include <QFuture>
+#include <QFutureInterface>
+#include <QSharedPointer>
+#include <QMutex>
+#include <QString>
+#include <QList>
+
+#include "ocrresult.h"
+
+#include <atomic>
+#include <functional>
+
+namespace Dtk {
+namespace Ocr {
+class DOcr;
+}
+}
+
+class QObject;
+
+/*
+ * @bref: OcrCancelToken 识别任务的取消标记
+ * 识别期间OCREngine会绑定正在使用的引擎实例(分块识别时为多个)，取消时中断这些实例的分析
+*/
+class OcrCancelToken
+{
+public:
+    void cancel();
+    bool isCancelled() const
+    {
+        return m_cancelled;
+    }
+
+    // 由OCREngine在analyze前后调用
+    void attach(Dtk::Ocr::DOcr *driver);
+    void detach(Dtk::Ocr::DOcr *driver);
+
+private:
+    std::atomic_bool m_cancelled {false};
+    QMutex m_mutex;
+    QList<Dtk::Ocr::DOcr *> m_drivers;
+};
+
+/*
+ * @bref: OcrJobHandle 异步识别任务的句柄，可拷贝，所有拷贝共享同一任务
+*/
+class OcrJobHandle
+{
+public:
+    OcrJobHandle() = default;
+
+    bool isValid() const
+    {
+        return !d.isNull();
+    }
+    quint64 id() const;
+    bool isFinished() const;
+    bool isCancelled() const;
+
+    // 任务结果，取消或失败时结果为空
+    QFuture<QString> future() const;
+    // 结构化结果，任务结束后有效，只有以结构化结果类型提交的任务才有数据
+    OcrResult structuredResult() const;
+    // 任务无法执行的原因(如图片解码失败)，任务结束后有效，为空表示没有出错
+    QString error() const;
+    // 批量识别结果，任务结束后有效，只有以submitBatch提交的任务才有数据
+    QList<OcrBatchResult> batchResults() const;
+    // 请求取消任务，排队中的任务不再执行，正在执行的任务会中断识别
+    void cancel();
+
+    /*
+    * @bref: onFinished 任务结束后在context所在线程回调，context销毁后不再回调
+    * 必须在context所在线程调用
+    * @param: callback 参数为识别结果和任务是否被取消
+    */
+    void onFinished(QObject *context, const std::function<void(const QString &result, bool cancelled)> &callback) const;
+
+private:
+    friend class OcrScheduler;
+
+    struct Data {
+        quint64 id {0};
+        OcrCancelToken token;
+        QFutureInterface<QString> future;
+        OcrResult structured;
+        QList<OcrBatchResult> batch;
+        QString error;
+    };
+
+    static OcrJobHandle create(quint64 id);
+    // 在reportResult之前调用，future结束后对其他线程可见
+    void setStructuredResult(const OcrResult &result) const;
+    void setBatchResults(const QList<OcrBatchResult> &results) const;
+    void setError(const QString &error) const;
+    void reportResult(const QString &result) const;
+    OcrCancelToken *token() const;
+
+    QSharedPointer<Data> d;
+};
+
+#endif // OCRJOB_H
@@ -0,0 +1,123 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "ocrresult.h"
+#include "tilelayout.h"
+
+#include <QDBusArgument>
+#include <QStringList>
+
+QPolygonF OcrResult::boxPolygon(int index) const
+{
+    QPolygonF polygon;
+    for (int i = index * PointsPerBox; i < (index + 1) * PointsPerBox; ++i) {
+        polygon << points.at(i);
+    }
+    return polygon;
+}
+
+QString OcrResult::toPlainText() const
+{
+    QStringList lineTexts;
+    for (int line = 0; line < lineCount(); ++line) {
+        QStringList words;
+        for (int i = lineStarts.at(line); i < lineStarts.at(line + 1); ++i) {
+            if (!boxText(i).isEmpty()) {
+                words << boxText(i).toString();
+            }
+        }
+        if (!words.isEmpty()) {
+            lineTexts << words.join(' ');
+        }
+    }
+    return lineTexts.join('\n');
+}
+
+OcrResult OcrResult::fromBoxes(const QList<OcrTextBox> &boxes)
+{
+    OcrResult result;
+    result.textOffsets.reserve(boxes.size() + 1);
+    result.points.reserve(boxes.size() * PointsPerBox);
+    result.confidences.reserve(boxes.size());
+    result.textOffsets << 0;
+    result.lineStarts << 0;
+
+    for (const QList<OcrTextBox> &line : TileLayout::groupLines(boxes)) {
+        for (const OcrTextBox &box : line) {
+            result.text += box.text;
+            result.textOffsets << static_cast<int>(result.text.size());
+            if (box.polygon.size() == PointsPerBox) {
+                for (const QPointF &point : box.polygon) {
+                    result.points << point;
+                }
+            } else {
+                QRectF bounds = box.polygon.boundingRect();
+                result.points << bounds.topLeft() << bounds.topRight() << bounds.bottomRight() << bounds.bottomLeft();
+            }
+            result.confidences << box.confidence;
+        }
+        result.lineStarts << result.confidences.size();
+    }
+    return result;
+}
+
+QDBusArgument &operator<<(QDBusArgument &argument, const OcrResult &result)
+{
+    QList<double> coordinates;
+    coordinates.reserve(result.points.size() * 2);
+    for (const QPointF &point : result.points) {
+        coordinates << point.x() << point.y();
+    }
+    QList<double> confidences;
+    confidences.reserve(result.confidences.size());
+    for (float confidence : result.confidences) {
+        confidences << confidence;
+    }
+
+    argument.beginStructure();
+    argument << result.text << coordinates << result.textOffsets.toList() << confidences << result.lineStarts.toList()
+             << result.orientation;
+    argument.endStructure();
+    return argument;
+}
+
+const QDBusArgument &operator>>(const QDBusArgument &argument, OcrResult &result)
+{
+    QList<double> coordinates;
+    QList<int> textOffsets;
+    QList<double> confidences;
+    QList<int> lineStarts;
+
+    argument.beginStructure();
+    argument >> result.text >> coordinates >> textOffsets >> confidences >> lineStarts >> result.orientation;
+    argument.endStructure();
+
+    result.points.clear();
+    for (int i = 0; i + 1 < coordinates.size(); i += 2) {
+        result.points << QPointF(coordinates.at(i), coordinates.at(i + 1));
+    }
+    result.textOffsets = textOffsets.toVector();
+    result.confidences.clear();
+    for (double confidence : confidences) {
+        result.confidences << static_cast<float>(confidence);
+    }
+    result.lineStarts = lineStarts.toVector();
+    return argument;
+}
+
+QDBusArgument &operator<<(QDBusArgument &argument, const OcrBatchResult &result)
+{
+    argument.beginStructure();
+    argument << result.text << result.success << result.decodeMs << result.recognizeMs;
+    argument.endStructure();
+    return argument;
+}
+
+const QDBusArgument &operator>>(const QDBusArgument &argument, OcrBatchResult &result)
+{
+    argument.beginStructure();
+    argument >> result.text >> result.success >> result.decodeMs >> result.recognizeMs;
+    argument.endStructure();
+    return argument;
+}
@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef OCRRESULT_H
+#define OCRRESULT_H
+
+#include <QPolygonF>
+#include <QImage>
+#include <QByteArray>
+#include <QString>
+#include <QStringView>
+#include <QList>
+#include <QVector>
+#include <QMetaType>
+
+#include <functional>
+
+class QDBusArgument;
+
+// 单个文本框的识别结果，坐标为原图坐标
+struct OcrTextBox {
+    QPolygonF polygon;
+    QString text;
+    float confidence {-1};  // 置信度，插件不提供时为-1
+};
+
+/*
+ * @bref: OcrResult 结构化的识别结果
+ * 各文本框按阅读顺序排列，数据存放在连续数组中，按下标直接访问，不需要解析字符串
+*/
+struct OcrResult {
+    // 每个文本框的顶点个数，非四边形的文本框取外接矩形
+    static constexpr int PointsPerBox = 4;
+
+    QString text;               // 所有文本框的文本依次拼接(UTF-16)
+    QVector<int> textOffsets;   // 第i个文本框的文本为text中[textOffsets[i], textOffsets[i+1])，大小为文本框个数+1
+    QVector<QPointF> points;    // 第i个文本框的顶点为points中[i*4, i*4+4)，原图坐标
+    QVector<float> confidences; // 第i个文本框的置信度，未知时为-1
+    QVector<int> lineStarts;    // 第l行的文本框下标为[lineStarts[l], lineStarts[l+1])，大小为行数+1
+    int orientation {0};        // 识别前检测到的页面方向，图片顺时针旋转该角度后文字为正向
+
+    int boxCount() const
+    {
+        return confidences.size();
+    }
+    int lineCount() const
+    {
+        return qMax(0, lineStarts.size() - 1);
+    }
+    QStringView boxText(int index) const
+    {
+        return QStringView(text).mid(textOffsets.at(index), textOffsets.at(index + 1) - textOffsets.at(index));
+    }
+    QPolygonF boxPolygon(int index) const;
+
+    // 按行拼接的纯文本，同一行的文本框以空格分隔
+    QString toPlainText() const;
+
+    // 文本框按阅读顺序分行后生成结果
+    static OcrResult fromBoxes(const QList<OcrTextBox> &boxes);
+};
+Q_DECLARE_METATYPE(OcrResult)
+
+// D-Bus传输格式为(sadaiadaii): 文本、顶点坐标(x0,y0,x1,y1...)、文本偏移、置信度、行起始下标、页面方向
+QDBusArgument &operator<<(QDBusArgument &argument, const OcrResult &result);
+const QDBusArgument &operator>>(const QDBusArgument &argument, OcrResult &result);
+
+// 批量识别的一项输入，按image、path、data的顺序取第一个非空的来源
+struct OcrBatchItem {
+    QImage image;
+    QString path;       // 图片文件路径
+    QByteArray data;    // 图片文件内容
+};
+
+// 批量识别的一项结果
+struct OcrBatchResult {
+    QString text;
+    bool success {false};       // 图片解码成功且识别未被取消
+    qint64 decodeMs {0};        // 解码耗时
+    qint64 recognizeMs {0};     // 识别耗时
+};
+Q_DECLARE_METATYPE(OcrBatchResult)
+
+// D-Bus传输格式为(sbxx): 文本、是否成功、解码耗时、识别耗时
+QDBusArgument &operator<<(QDBusArgument &argument, const OcrBatchResult &result);
+const QDBusArgument &operator>>(const QDBusArgument &argument, OcrBatchResult &result);
+
+// 批量识别中一项完成后的回调，可能在工作线程中调用
+using OcrBatchProgressCallback = std::function<void(int index, const OcrBatchResult &result)>;
+
+// 识别过程中的部分结果回调，text为已完成的一行或多行文本，可能在工作线程中调用
+using OcrPartialResultCallback = std::function<void(const QString &text)>;
+
+#endif // OCRRESULT_H
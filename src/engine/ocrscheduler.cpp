@@ -0,0 +1,208 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "ocrscheduler.h"
+#include "OCREngine.h"
+#include "functionrunnable.h"
+#include "util/log.h"
+
+#include <QMutexLocker>
+#include <dconfigmanager.h>
+
+#include <atomic>
+
+// 默认的等待队列长度
+static constexpr int kDefaultQueueDepth = 32;
+
+OcrScheduler *OcrScheduler::instance()
+{
+    static OcrScheduler ins;
+    return &ins;
+}
+
+OcrScheduler::OcrScheduler(QObject *parent)
+    : QObject(parent)
+{
+    m_maxConcurrency = qMax(1, OCREngine::maxPoolSize());
+    m_maxQueueDepth = DConfigManager::instance()->value(COMMON_GROUP, COMMON_MAXQUEUEDEPTH, kDefaultQueueDepth).toInt();
+    if (m_maxQueueDepth <= 0) {
+        m_maxQueueDepth = kDefaultQueueDepth;
+    }
+
+    //线程常驻，避免每次识别创建和销毁线程
+    m_threadPool.setMaxThreadCount(m_maxConcurrency);
+    m_threadPool.setExpiryTimeout(-1);
+    qCInfo(dmOcr) << "OCR scheduler started, concurrency:" << m_maxConcurrency << "queue depth:" << m_maxQueueDepth;
+}
+
+OcrScheduler::~OcrScheduler()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        for (auto &queue : m_queues) {
+            queue.clear();
+        }
+    }
+    m_threadPool.waitForDone();
+}
+
+OcrJobHandle OcrScheduler::submit(const QImage &image, const QString &language, Priority priority, ResultType resultType,
+                                  const QRect &region, bool streaming)
+{
+    Job job;
+    job.image = image;
+    job.language = language;
+    job.region = region;
+    job.priority = priority;
+    job.resultType = resultType;
+    job.streaming = streaming;
+    return enqueue(job);
+}
+
+OcrJobHandle OcrScheduler::submit(const ImageLoader &loader, const QString &language, Priority priority,
+                                  ResultType resultType, const QRect &region, bool streaming)
+{
+    Job job;
+    job.loader = loader;
+    job.language = language;
+    job.region = region;
+    job.priority = priority;
+    job.resultType = resultType;
+    job.streaming = streaming;
+    return enqueue(job);
+}
+
+OcrJobHandle OcrScheduler::submitBatch(const QList<OcrBatchItem> &items, const QString &language, Priority priority)
+{
+    Job job;
+    job.isBatch = true;
+    job.batch = items;
+    job.language = language;
+    job.priority = priority;
+    return enqueue(job);
+}
+
+OcrJobHandle OcrScheduler::enqueue(Job &job)
+{
+    QMutexLocker locker(&m_mutex);
+    int pending = 0;
+    for (const auto &queue : m_queues) {
+        pending += queue.size();
+    }
+    if (pending >= m_maxQueueDepth) {
+        qCWarning(dmOcr) << "OCR queue is full, rejecting job, pending:" << pending;
+        return OcrJobHandle();
+    }
+
+    job.handle = OcrJobHandle::create(m_nextJobId++);
+    job.queuedTimer.start();
+    m_queues[job.priority].enqueue(job);
+    qCDebug(dmOcr) << "OCR job" << job.handle.id() << "queued, priority:" << job.priority << "pending:" << pending + 1;
+    locker.unlock();
+
+    dispatch();
+    return job.handle;
+}
+
+bool OcrScheduler::isFull() const
+{
+    return pendingCount() >= m_maxQueueDepth;
+}
+
+int OcrScheduler::pendingCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    int pending = 0;
+    for (const auto &queue : m_queues) {
+        pending += queue.size();
+    }
+    return pending;
+}
+
+void OcrScheduler::dispatch()
+{
+    QMutexLocker locker(&m_mutex);
+    while (m_running < m_maxConcurrency) {
+        //按优先级从高到低取任务
+        QQueue<Job> *queue = nullptr;
+        for (auto &candidate : m_queues) {
+            if (!candidate.isEmpty()) {
+                queue = &candidate;
+                break;
+            }
+        }
+        if (!queue) {
+            return;
+        }
+
+        Job job = queue->dequeue();
+        ++m_running;
+        m_threadPool.start(new FunctionRunnable([this, job]() {
+            runJob(job);
+        }));
+    }
+}
+
+void OcrScheduler::runJob(const Job &job)
+{
+    //引擎预热完成前到达的任务等待就绪，等待时间计入排队时间
+    OCREngine::readiness().waitForFinished();
+    qint64 waitMs = job.queuedTimer.elapsed();
+    QElapsedTimer serviceTimer;
+    serviceTimer.start();
+
+    //需要解码的图片在工作线程中解码，不占用提交任务的线程
+    QImage image = job.image;
+    QString error;
+    if (job.loader && !job.handle.isCancelled()) {
+        image = job.loader();
+        if (image.isNull()) {
+            error = "Failed to load image data";
+        } else if (!job.region.isNull() && !job.region.intersects(image.rect())) {
+            error = "Region is empty or outside the image";
+        }
+    }
+
+    //排队期间被取消的任务不再识别
+    QString result;
+    if (!error.isEmpty()) {
+        qCWarning(dmOcr) << "OCR job" << job.handle.id() << "failed:" << error;
+        job.handle.setError(error);
+    } else if (job.isBatch) {
+        //批量任务内部按引擎池大小并行，取消标记对其中每一项生效
+        job.handle.setBatchResults(OCREngine::instance()->recognizeBatch(job.batch, job.language, job.handle.token()));
+    } else if (!job.handle.isCancelled() && job.resultType == StructuredResult) {
+        OcrResult structured = OCREngine::instance()->recognizeResult(image, job.language, job.handle.token(), job.region);
+        result = structured.toPlainText();
+        job.handle.setStructuredResult(structured);
+    } else if (!job.handle.isCancelled()) {
+        //只有调用方需要部分结果时才按条带识别，否则走整图识别
+        OcrPartialResultCallback partial;
+        std::atomic_bool reported {false};
+        const quint64 jobId = job.handle.id();
+        if (job.streaming) {
+            partial = [this, jobId, &reported](const QString &text) {
+                reported = true;
+                Q_EMIT jobPartialResult(jobId, text);
+            };
+        }
+        result = OCREngine::instance()->recognize(image, job.language, job.handle.token(), partial, job.region);
+        //较小的图片整图识别(或命中缓存)，不会产生部分结果，以完整文本发出一次，调用方只需处理一种进度信号
+        if (job.streaming && !reported && !result.isEmpty() && !job.handle.isCancelled()) {
+            Q_EMIT jobPartialResult(jobId, result);
+        }
+    }
+
+    qint64 serviceMs = serviceTimer.elapsed();
+    qCInfo(dmOcr) << "OCR job" << job.handle.id() << (job.handle.isCancelled() ? "cancelled" : "finished")
+                  << "priority:" << job.priority << "wait:" << waitMs << "ms service:" << serviceMs << "ms";
+
+    {
+        QMutexLocker locker(&m_mutex);
+        --m_running;
+    }
+    job.handle.reportResult(result);
+    Q_EMIT jobFinished(job.handle.id(), result, waitMs, serviceMs);
+    dispatch();
+}
@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef OCRSCHEDULER_H
+#define OCRSCHEDULER_H
+
+#include <QObject>
+#include <QImage>
+#include <QQueue>
+#include <QMutex>
+#include <QThreadPool>
+#include <QElapsedTimer>
+
+#include <functional>
+
+#include "ocrjob.h"
+
+/*
+ * @bref: OcrScheduler 识别任务调度器
+ * 任务按优先级进入先进先出队列，由常驻线程池按引擎池大小并发执行
+*/
+class OcrScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    // 任务优先级，交互窗口的任务总是先于后台任务执行
+    enum Priority {
+        Interactive = 0,
+        Background,
+        PriorityCount
+    };
+    Q_ENUM(Priority)
+
+    // 任务结果类型，结构化结果包含文本框位置，通过OcrJobHandle::structuredResult获取
+    enum ResultType {
+        TextResult = 0,
+        StructuredResult
+    };
+    Q_ENUM(ResultType)
+
+    // 在工作线程中解码图片，返回空图片表示解码失败
+    using ImageLoader = std::function<QImage()>;
+
+    static OcrScheduler *instance();
+
+    /*
+    * @bref: submit 提交异步识别任务
+    * @param: image 待识别图片
+    * @param: language 识别语言，为空时使用引擎默认语言
+    * @param: priority 任务优先级
+    * @param: resultType 结果类型
+    * @param: region 识别区域(图片坐标)，为空时识别整张图片
+    * @param: streaming 是否需要部分结果，为true时识别过程中发出jobPartialResult
+    * @return: 任务句柄，队列已满时返回无效句柄
+    */
+    OcrJobHandle submit(const QImage &image, const QString &language = QString(), Priority priority = Interactive,
+                        ResultType resultType = TextResult, const QRect &region = QRect(), bool streaming = false);
+
+    /*
+    * @bref: submit 提交需要解码的识别任务，图片在执行任务的工作线程中由loader解码
+    * 解码失败或region不在图片内时任务结束并通过OcrJobHandle::error给出原因
+    */
+    OcrJobHandle submit(const ImageLoader &loader, const QString &language, Priority priority, ResultType resultType,
+                        const QRect &region = QRect(), bool streaming = false);
+
+    /*
+    * @bref: submitBatch 提交批量识别任务，整批占用一个队列位置
+    * 任务内部由OCREngine::recognizeBatch并行解码和识别，结果通过OcrJobHandle::batchResults获取
+    * @param: items 待识别的图片
+    * @param: language 识别语言，为空时使用引擎默认语言
+    * @param: priority 任务优先级
+    * @return: 任务句柄，队列已满时返回无效句柄
+    */
+    OcrJobHandle submitBatch(const QList<OcrBatchItem> &items, const QString &language = QString(),
+                             Priority priority = Background);
+
+    // 等待队列是否已满
+    bool isFull() const;
+    int pendingCount() const;
+
+Q_SIGNALS:
+    /*
+    * @bref: jobPartialResult 以streaming提交的任务识别完成了一部分文本行，在工作线程中按阅读顺序发出
+    * 较高的图片按条带识别，每完成一条发出一次；其余图片在识别完成后以完整文本发出一次
+    * 任务结束时的完整结果仍由jobFinished给出
+    */
+    void jobPartialResult(quint64 jobId, const QString &text);
+
+    /*
+    * @bref: jobFinished 任务结束(包括被取消)，在工作线程中发出
+    * @param: waitMs 任务在队列中等待的时间
+    * @param: serviceMs 任务识别耗时
+    */
+    void jobFinished(quint64 jobId, const QString &result, qint64 waitMs, qint64 serviceMs);
+
+private:
+    explicit OcrScheduler(QObject *parent = nullptr);
+    ~OcrScheduler() override;
+
+    struct Job {
+        OcrJobHandle handle;
+        QImage image;
+        ImageLoader loader;         // 不为空时在工作线程中解码得到image
+        QString language;
+        QRect region;
+        Priority priority {Interactive};
+        ResultType resultType {TextResult};
+        bool streaming {false};
+        bool isBatch {false};       // 批量任务，识别batch中的图片，忽略image
+        QList<OcrBatchItem> batch;
+        QElapsedTimer queuedTimer;
+    };
+
+    // 任务入队，队列已满时返回无效句柄
+    OcrJobHandle enqueue(Job &job);
+    // 在并发数未满时从队列中取出任务执行
+    void dispatch();
+    void runJob(const Job &job);
+
+    mutable QMutex m_mutex;
+    QQueue<Job> m_queues[PriorityCount];
+    quint64 m_nextJobId {1};
+    int m_running {0};
+    int m_maxConcurrency {1};
+    int m_maxQueueDepth {32};
+    QThreadPool m_threadPool;
+};
+
+#endif // OCRSCHEDULER_H
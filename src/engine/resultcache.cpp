@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "resultcache.h"
+#include "imagehash.h"
+#include "util/log.h"
+
+#include <QMutexLocker>
+
+#include <limits>
+
+// 记录摘要的图片个数
+static constexpr int kDigestMemoSize = 64;
+
+ResultCache::ResultCache(qint64 budgetBytes)
+    : m_enabled(budgetBytes > 0)
+{
+    //QCache的cost为int，预算按字节计算不会超过int范围
+    m_cache.setMaxCost(static_cast<int>(qBound<qint64>(0, budgetBytes, std::numeric_limits<int>::max())));
+    m_digests.setMaxCost(kDigestMemoSize);
+}
+
+QString ResultCache::makeKey(quint64 digest, const QString &language, const QString &pluginName, const QString &variant)
+{
+    QString key = QString::number(digest, 16) + '|' + language + '|' + pluginName;
+    if (!variant.isEmpty()) {
+        key += '|' + variant;
+    }
+    return key;
+}
+
+quint64 ResultCache::digest(const QImage &image)
+{
+    const qint64 imageKey = image.cacheKey();
+    {
+        QMutexLocker locker(&m_mutex);
+        if (quint64 *cached = m_digests.object(imageKey)) {
+            return *cached;
+        }
+    }
+
+    quint64 value = ImageHash::digest(image);
+    QMutexLocker locker(&m_mutex);
+    m_digests.insert(imageKey, new quint64(value));
+    return value;
+}
+
+bool ResultCache::find(const QString &key, QString *result)
+{
+    if (!m_enabled) {
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    //QCache::object会将该项移到最近使用的位置
+    QString *cached = m_cache.object(key);
+    if (!cached) {
+        ++m_misses;
+        qCDebug(dmOcr) << "Result cache miss, hits:" << m_hits << "misses:" << m_misses;
+        return false;
+    }
+
+    ++m_hits;
+    *result = *cached;
+    qCDebug(dmOcr) << "Result cache hit, hits:" << m_hits << "misses:" << m_misses;
+    return true;
+}
+
+void ResultCache::insert(const QString &key, const QString &result)
+{
+    if (!m_enabled) {
+        return;
+    }
+
+    // QString按UTF-16存储，cost计算键和值占用的字节数
+    int cost = static_cast<int>((key.size() + result.size()) * sizeof(QChar));
+    QMutexLocker locker(&m_mutex);
+    m_cache.insert(key, new QString(result), qMax(1, cost));
+}
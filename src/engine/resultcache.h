@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include <QCache>
+#include <QMutex>
+#include <QString>
+#include <QImage>
+
+#include <atomic>
+
+/*
+ * @bref: ResultCache 识别结果的内存缓存，按最近最少使用淘汰
+ * 以图片摘要、识别语言和插件名作为键，总占用不超过内存预算
+*/
+class ResultCache
+{
+public:
+    explicit ResultCache(qint64 budgetBytes);
+
+    // variant区分同一图片不同方式得到的文本(如按条带流式识别)，为空时不加入键
+    static QString makeKey(quint64 digest, const QString &language, const QString &pluginName,
+                           const QString &variant = QString());
+
+    // 图片摘要，同一份像素数据(QImage::cacheKey相同)只计算一次
+    quint64 digest(const QImage &image);
+
+    bool isEnabled() const
+    {
+        return m_enabled;
+    }
+
+    // 查找结果，命中时写入result并返回true
+    bool find(const QString &key, QString *result);
+    void insert(const QString &key, const QString &result);
+
+private:
+    bool m_enabled {false};
+    QMutex m_mutex;
+    QCache<QString, QString> m_cache;   // 以字节数作为cost
+    QCache<qint64, quint64> m_digests;  // QImage::cacheKey到摘要的映射
+    // 命中和未命中次数，只用于日志
+    std::atomic<quint64> m_hits {0};
+    std::atomic<quint64> m_misses {0};
+};
+
+#endif // RESULTCACHE_H
@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "scriptdetector.h"
+#include "imagepreprocess.h"
+#include "util/log.h"
+
+#include <QPainter>
+#include <QVector>
+
+#include <algorithm>
+#include <atomic>
+
+const QString ScriptDetector::AutoLanguage = "auto";
+const QString ScriptDetector::ProbeLanguage = "zh-Hans_en";
+
+// 探测时选取的文字行数
+static constexpr int kSampleRows = 3;
+// 汉字占文字的比例低于该值时视为英文
+static constexpr qreal kMinHanRatio = 0.1;
+
+// 常用字中繁体和简体写法不同的字，分别只出现在繁体或简体文本中
+static const QString kTraditionalChars = QStringLiteral(
+    "這們個會來時為說國學對發經實體點開關長麼與還進應過間問題線電話見當樣現網頁書車門東區無從記號務種雙歲語資訊傳統產業廣際陽陰聽讓認識寫讀買賣飛機場條錢頭"
+);
+static const QString kSimplifiedChars = QStringLiteral(
+    "这们个会来时为说国学对发经实体点开关长么与还进应过间问题线电话见当样现网页书车门东区无从记号务种双岁语资讯传统产业广际阳阴听让认识写读买卖飞机场条钱头"
+);
+
+static std::atomic_int s_detections {0};
+static std::atomic_int s_overrides {0};
+
+bool ScriptDetector::canProbe(const QString &language)
+{
+    return language == "zh-Hans_en" || language == "zh-Hant_en";
+}
+
+QImage ScriptDetector::sampleImage(const QImage &image)
+{
+    QList<ImagePreprocess::TextRow> rows = ImagePreprocess::textRows(image);
+    if (rows.isEmpty()) {
+        return QImage();
+    }
+
+    //去掉高度明显偏离中位数的行(标题、表格线、噪点)
+    QVector<int> heights;
+    for (const auto &row : rows) {
+        heights << row.height;
+    }
+    std::nth_element(heights.begin(), heights.begin() + heights.size() / 2, heights.end());
+    const int median = heights.at(heights.size() / 2);
+    rows.erase(std::remove_if(rows.begin(), rows.end(), [median](const ImagePreprocess::TextRow &row) {
+        return row.height * 2 < median || row.height > median * 2;
+    }), rows.end());
+    if (rows.isEmpty()) {
+        return QImage();
+    }
+
+    //在全部行中均匀选取，覆盖图片的不同部分
+    QList<QRect> crops;
+    const int count = qMin(kSampleRows, rows.size());
+    const int padding = median / 4;
+    for (int i = 0; i < count; ++i) {
+        const auto &row = rows.at(count == 1 ? 0 : (rows.size() - 1) * i / (count - 1));
+        crops << QRect(0, row.top - padding, image.width(), row.height + padding * 2).intersected(image.rect());
+    }
+
+    const int gap = median / 2;
+    int height = 0;
+    for (const QRect &crop : crops) {
+        height += crop.height() + gap;
+    }
+    QImage sample(image.width(), height, QImage::Format_RGB888);
+    //间隔使用图片左上角的颜色，与背景一致
+    sample.fill(image.pixelColor(0, 0));
+    QPainter painter(&sample);
+    int y = gap / 2;
+    for (const QRect &crop : crops) {
+        painter.drawImage(QPoint(0, y), image, crop);
+        y += crop.height() + gap;
+    }
+    return sample;
+}
+
+QString ScriptDetector::classify(const QString &text)
+{
+    int latin = 0;
+    int han = 0;
+    int traditional = 0;
+    int simplified = 0;
+    for (const QChar &c : text) {
+        if (c.script() == QChar::Script_Han) {
+            ++han;
+            if (kTraditionalChars.contains(c)) {
+                ++traditional;
+            } else if (kSimplifiedChars.contains(c)) {
+                ++simplified;
+            }
+        } else if (c.script() == QChar::Script_Latin && c.isLetter()) {
+            ++latin;
+        }
+    }
+
+    if (han + latin == 0) {
+        return ProbeLanguage;
+    }
+    if (han < kMinHanRatio * (han + latin)) {
+        return "en";
+    }
+    return traditional > simplified ? "zh-Hant_en" : "zh-Hans_en";
+}
+
+void ScriptDetector::recordDetection(const QString &language)
+{
+    ++s_detections;
+    qCInfo(dmOcr) << "Language auto-detected:" << language;
+    logStatistics();
+}
+
+void ScriptDetector::recordOverride()
+{
+    ++s_overrides;
+    logStatistics();
+}
+
+void ScriptDetector::logStatistics()
+{
+    const int detections = s_detections;
+    const int overrides = s_overrides;
+    if (detections <= 0) {
+        return;
+    }
+    qCInfo(dmOcr) << "Language auto-detection statistics, detections:" << detections << "user overrides:" << overrides
+                  << "re-runs avoided:" << QString::number(100.0 * (detections - qMin(overrides, detections)) / detections, 'f', 1) + "%";
+}
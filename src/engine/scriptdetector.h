@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SCRIPTDETECTOR_H
+#define SCRIPTDETECTOR_H
+
+#include <QImage>
+#include <QString>
+
+/*
+ * @bref: ScriptDetector 识别语言的自动选择
+ * 从图片中选取几行文字拼成小图，用探测语言的模型快速识别，
+ * 再按结果中各类文字的比例选择完整识别使用的语言
+*/
+class ScriptDetector
+{
+public:
+    // 表示自动选择语言的语言名
+    static const QString AutoLanguage;
+    // 探测使用的语言，同时识别简体中文和英文
+    static const QString ProbeLanguage;
+
+    // 该语言的模型能否用于探测：中文模型同时识别汉字和拉丁字母，英文模型无法区分汉字
+    static bool canProbe(const QString &language);
+
+    /*
+    * @bref: sampleImage 选取几行高度接近中位数的文字，按原宽度纵向拼接
+    * @return: 探测用的图片，没有找到文字行时返回空图片
+    */
+    static QImage sampleImage(const QImage &image);
+
+    /*
+    * @bref: classify 根据探测结果中汉字和拉丁字母的比例及繁简特有字选择语言
+    * @return: zh-Hans_en、zh-Hant_en或en，无法判断时返回ProbeLanguage
+    */
+    static QString classify(const QString &text);
+
+    // 记录一次自动选择的结果
+    static void recordDetection(const QString &language);
+    // 记录一次用户在自动选择后手动切换语言(需要重新识别)
+    static void recordOverride();
+
+private:
+    static void logStatistics();
+    ScriptDetector() = delete;
+};
+
+#endif // SCRIPTDETECTOR_H
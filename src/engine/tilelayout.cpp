@@ -0,0 +1,237 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "tilelayout.h"
+
+#include <QStringList>
+
+#include <algorithm>
+
+// 两个文本框重叠面积超过较小者的该比例时视为重复
+static constexpr qreal kDuplicateOverlapRatio = 0.5;
+// 两个文本框垂直方向重叠超过较矮者的该比例时视为同一行
+static constexpr qreal kSameLineOverlapRatio = 0.5;
+// 左右相邻分块裁剪出的文本框边缘相距不超过该值(像素)时拼接为一个文本框
+static constexpr qreal kSeamTolerance = 2;
+
+namespace {
+// 一个方向上各分块的起点，分块均匀分布且首尾贴合图片边缘
+QList<int> tilePositions(int length, int tileSize, int overlap)
+{
+    QList<int> positions;
+    if (length <= tileSize) {
+        positions << 0;
+        return positions;
+    }
+    const int step = tileSize - overlap;
+    const int count = (length - overlap + step - 1) / step;
+    for (int i = 0; i < count; ++i) {
+        positions << static_cast<int>(static_cast<qint64>(length - tileSize) * i / (count - 1));
+    }
+    return positions;
+}
+
+// 相邻分块以重叠区域的中线为界划分core
+QList<QPair<int, int>> coreRanges(const QList<int> &positions, int tileLength, int length)
+{
+    QList<QPair<int, int>> ranges;
+    for (int i = 0; i < positions.size(); ++i) {
+        int begin = i == 0 ? 0 : (positions.at(i) + positions.at(i - 1) + tileLength) / 2;
+        int end = i == positions.size() - 1 ? length : (positions.at(i + 1) + positions.at(i) + tileLength) / 2;
+        ranges << qMakePair(begin, end);
+    }
+    return ranges;
+}
+
+qreal area(const QRectF &rect)
+{
+    return rect.width() * rect.height();
+}
+
+// 垂直方向重叠超过较矮者的一定比例
+bool onSameLine(const QRectF &a, const QRectF &b)
+{
+    const qreal overlap = qMin(a.bottom(), b.bottom()) - qMax(a.top(), b.top());
+    return overlap > kSameLineOverlapRatio * qMin(a.height(), b.height());
+}
+
+// 裁剪文本框的水平范围，文本按字符平均宽度截取范围内的部分
+OcrTextBox clipBox(const OcrTextBox &box, qreal left, qreal right)
+{
+    const QRectF bounds = box.polygon.boundingRect();
+    const int length = box.text.size();
+    const int first = qRound(length * (left - bounds.left()) / bounds.width());
+    const int last = qRound(length * (right - bounds.left()) / bounds.width());
+    OcrTextBox clipped = box;
+    clipped.text = box.text.mid(first, last - first);
+    clipped.polygon = QPolygonF(QRectF(QPointF(left, bounds.top()), QPointF(right, bounds.bottom())));
+    return clipped;
+}
+}
+
+QList<TileLayout::Tile> TileLayout::split(const QSize &size, int tileSize, int overlap)
+{
+    return split(size, QSize(tileSize, tileSize), overlap);
+}
+
+QList<TileLayout::Tile> TileLayout::split(const QSize &size, const QSize &tileSize, int overlap)
+{
+    const int tileWidth = qMin(tileSize.width(), size.width());
+    const int tileHeight = qMin(tileSize.height(), size.height());
+    const QList<int> xs = tilePositions(size.width(), tileSize.width(), qBound(0, overlap, tileSize.width() / 2));
+    const QList<int> ys = tilePositions(size.height(), tileSize.height(), qBound(0, overlap, tileSize.height() / 2));
+    const auto xCores = coreRanges(xs, tileWidth, size.width());
+    const auto yCores = coreRanges(ys, tileHeight, size.height());
+
+    QList<Tile> tiles;
+    for (int row = 0; row < ys.size(); ++row) {
+        for (int col = 0; col < xs.size(); ++col) {
+            Tile tile;
+            tile.rect = QRect(xs.at(col), ys.at(row), tileWidth, tileHeight);
+            tile.core = QRect(QPoint(xCores.at(col).first, yCores.at(row).first),
+                              QPoint(xCores.at(col).second - 1, yCores.at(row).second - 1));
+            tiles << tile;
+        }
+    }
+    return tiles;
+}
+
+QList<OcrTextBox> TileLayout::merge(const QList<Tile> &tiles, const std::vector<QList<OcrTextBox>> &tileBoxes)
+{
+    QList<OcrTextBox> merged;
+    QList<int> owners;
+    // 跨越左右分块边界、已裁剪到所属core内的文本框
+    QList<OcrTextBox> pieces;
+    for (int i = 0; i < tiles.size() && i < static_cast<int>(tileBoxes.size()); ++i) {
+        const Tile &tile = tiles.at(i);
+        const qreal coreLeft = tile.core.left();
+        const qreal coreRight = tile.core.left() + tile.core.width();
+        for (OcrTextBox box : tileBoxes.at(i)) {
+            box.polygon.translate(tile.rect.topLeft());
+            QRectF bounds = box.polygon.boundingRect();
+            //文字行远低于重叠宽度，垂直方向按中心点归属分块
+            const qreal centerY = bounds.center().y();
+            if (centerY < tile.core.top() || centerY >= tile.core.top() + tile.core.height()) {
+                continue;
+            }
+
+            //水平方向一行文字可能跨越分块边界，两侧分块都识别了重叠区域内的字符，
+            //各自只保留core内的部分，之后再拼接，避免重叠区域的字符重复
+            const qreal left = qMax(bounds.left(), coreLeft);
+            const qreal right = qMin(bounds.right(), coreRight);
+            if (right <= left) {
+                continue;
+            }
+            if (left > bounds.left() || right < bounds.right()) {
+                pieces << clipBox(box, left, right);
+                continue;
+            }
+
+            //跨越分块边界的文本框可能在两个分块中都被完整识别，保留文本较长的一个
+            bool duplicated = false;
+            for (int j = 0; j < merged.size(); ++j) {
+                if (owners.at(j) == i) {
+                    continue;
+                }
+                QRectF other = merged.at(j).polygon.boundingRect();
+                qreal overlapArea = area(bounds.intersected(other));
+                if (overlapArea > kDuplicateOverlapRatio * qMin(area(bounds), area(other))) {
+                    if (box.text.size() > merged.at(j).text.size()) {
+                        merged[j] = box;
+                        owners[j] = i;
+                    }
+                    duplicated = true;
+                    break;
+                }
+            }
+            if (!duplicated) {
+                merged << box;
+                owners << i;
+            }
+        }
+    }
+
+    //从左到右拼接同一行中在分块边界处相接的部分
+    std::sort(pieces.begin(), pieces.end(), [](const OcrTextBox &a, const OcrTextBox &b) {
+        return a.polygon.boundingRect().left() < b.polygon.boundingRect().left();
+    });
+    QList<OcrTextBox> stitched;
+    for (const OcrTextBox &piece : pieces) {
+        const QRectF bounds = piece.polygon.boundingRect();
+        bool joined = false;
+        for (OcrTextBox &line : stitched) {
+            const QRectF lineBounds = line.polygon.boundingRect();
+            if (qAbs(lineBounds.right() - bounds.left()) <= kSeamTolerance && onSameLine(lineBounds, bounds)) {
+                line.text += piece.text;
+                line.polygon = QPolygonF(lineBounds.united(bounds));
+                if (line.confidence >= 0 && piece.confidence >= 0) {
+                    line.confidence = qMin(line.confidence, piece.confidence);
+                }
+                joined = true;
+                break;
+            }
+        }
+        if (!joined) {
+            stitched << piece;
+        }
+    }
+    merged << stitched;
+    return merged;
+}
+
+QList<QList<OcrTextBox>> TileLayout::groupLines(const QList<OcrTextBox> &boxes)
+{
+    QList<OcrTextBox> sorted = boxes;
+    std::sort(sorted.begin(), sorted.end(), [](const OcrTextBox &a, const OcrTextBox &b) {
+        return a.polygon.boundingRect().top() < b.polygon.boundingRect().top();
+    });
+
+    //按垂直方向的重叠程度分行
+    QList<QList<OcrTextBox>> lines;
+    QList<QPair<qreal, qreal>> lineRanges;
+    for (const OcrTextBox &box : sorted) {
+        QRectF bounds = box.polygon.boundingRect();
+        bool added = false;
+        for (int i = 0; i < lines.size(); ++i) {
+            qreal top = qMax(bounds.top(), lineRanges.at(i).first);
+            qreal bottom = qMin(bounds.bottom(), lineRanges.at(i).second);
+            qreal minHeight = qMin(bounds.height(), lineRanges.at(i).second - lineRanges.at(i).first);
+            if (bottom - top > kSameLineOverlapRatio * minHeight) {
+                lines[i] << box;
+                lineRanges[i].first = qMin(lineRanges.at(i).first, bounds.top());
+                lineRanges[i].second = qMax(lineRanges.at(i).second, bounds.bottom());
+                added = true;
+                break;
+            }
+        }
+        if (!added) {
+            lines << QList<OcrTextBox> {box};
+            lineRanges << qMakePair(bounds.top(), bounds.bottom());
+        }
+    }
+
+    for (QList<OcrTextBox> &line : lines) {
+        std::sort(line.begin(), line.end(), [](const OcrTextBox &a, const OcrTextBox &b) {
+            return a.polygon.boundingRect().left() < b.polygon.boundingRect().left();
+        });
+    }
+    return lines;
+}
+
+QString TileLayout::toText(const QList<OcrTextBox> &boxes)
+{
+    QStringList lineTexts;
+    for (const QList<OcrTextBox> &line : groupLines(boxes)) {
+        QStringList words;
+        for (const OcrTextBox &box : line) {
+            if (!box.text.isEmpty()) {
+                words << box.text;
+            }
+        }
+        if (!words.isEmpty()) {
+            lineTexts << words.join(' ');
+        }
+    }
+    return lineTexts.join('\n');
+}
@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef TILELAYOUT_H
+#define TILELAYOUT_H
+
+#include "ocrresult.h"
+
+#include <QRect>
+#include <QSize>
+
+#include <vector>
+
+/*
+ * @bref: TileLayout 大图分块识别的切分与结果合并
+*/
+class TileLayout
+{
+public:
+    struct Tile {
+        QRect rect;     // 分块在原图中的区域
+        QRect core;     // 分块负责的区域，相邻分块的core互不重叠且拼接后覆盖整图
+    };
+
+    /*
+    * @bref: split 将图片切分为相互重叠的分块
+    * @param: tileSize 分块边长
+    * @param: overlap 相邻分块的最小重叠宽度
+    */
+    static QList<Tile> split(const QSize &size, int tileSize, int overlap);
+    // 按指定的分块宽高切分，宽度不小于图片宽度时切分为水平条带
+    static QList<Tile> split(const QSize &size, const QSize &tileSize, int overlap);
+
+    /*
+    * @bref: merge 合并各分块的识别结果
+    * 文本框坐标转换为原图坐标，垂直方向只保留中心点落在所属分块core内的文本框；
+    * 水平方向跨越分块边界的文本框裁剪到core内(文本按字符平均宽度截取)，再与相邻分块的部分拼接为一行，
+    * 并去掉不同分块中重复识别的同一文本框
+    * @param: tileBoxes 各分块的识别结果，坐标相对于分块
+    */
+    static QList<OcrTextBox> merge(const QList<Tile> &tiles, const std::vector<QList<OcrTextBox>> &tileBoxes);
+
+    // 按阅读顺序(从上到下、从左到右)分行，垂直方向重叠较多的文本框属于同一行
+    static QList<QList<OcrTextBox>> groupLines(const QList<OcrTextBox> &boxes);
+    // 按阅读顺序拼接文本，同一行的文本框以空格分隔
+    static QString toText(const QList<OcrTextBox> &boxes);
+
+private:
+    TileLayout() = delete;
+};
+
+#endif // TILELAYOUT_H
@@ -16,24 +16,45 @@
 #include <QCoreApplication>
 #include <QDBusConnection>
 #include <QDBusInterface>
+#include <QElapsedTimer>
 #include "util/log.h"
+#include "engine/OCREngine.h"
+#include "utils/dconfigmanager.h"
 
 DWIDGET_USE_NAMESPACE
 
 int main(int argc, char *argv[])
 {
+    QElapsedTimer startupTimer;
+    startupTimer.start();
 
     if (argc < 2) {
         qDebug() << "Cant open a null file";
         return 0;
     }
 
+    // 以D-Bus服务启动且没有图形会话时使用offscreen平台，只提供不打开窗口的识别方法
+    bool headless = false;
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM") && qEnvironmentVariableIsEmpty("DISPLAY")
+            && qEnvironmentVariableIsEmpty("WAYLAND_DISPLAY")) {
+        for (int i = 1; i < argc; ++i) {
+            if (qstrcmp(argv[i], "-u") == 0 || qstrcmp(argv[i], "--dbus") == 0) {
+                headless = true;
+            }
+        }
+    }
+    if (headless) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
     DGuiApplicationHelper::setUseInactiveColorGroup(false);
 #endif
 
 #if(DTK_VERSION < DTK_VERSION_CHECK(5,4,0,0))
-    DApplication::loadDXcbPlugin();
+    if (!headless) {
+        DApplication::loadDXcbPlugin();
+    }
     QScopedPointer<DApplication> app(new DApplication(argc, argv));
 #else
     QScopedPointer<DApplication> app(DApplication::globalApplication(argc, argv));
@@ -43,7 +64,7 @@ int main(int argc, char *argv[])
     app->setProductName(QObject::tr("OCR Tool"));
     app->setApplicationVersion("1.0");
 
-    qCInfo(dmOcr) << "Starting Deepin OCR Tool version 1.0";
+    qCInfo(dmOcr) << "Starting Deepin OCR Tool version 1.0" << (headless ? "(headless)" : "");
 
     Dtk::Core::DLogManager::registerConsoleAppender();
     Dtk::Core::DLogManager::registerFileAppender();
@@ -57,6 +78,7 @@ int main(int argc, char *argv[])
     cmdParser.process(*app);
 
     app->loadTranslator();
+    qCInfo(dmOcr) << "Startup phase: application initialized at" << startupTimer.elapsed() << "ms";
 
     OcrApplication instance;
     QDBusConnection dbus = QDBusConnection::sessionBus();
@@ -68,6 +90,12 @@ int main(int argc, char *argv[])
         dbus.registerObject("/com/deepin/Ocr", &instance);
         // 初始化适配器
         new DbusOcrAdaptor(&instance);
+        qCInfo(dmOcr) << "Startup phase: DBus service registered at" << startupTimer.elapsed() << "ms";
+
+        // 引擎创建和模型加载较慢，在后台线程提前完成，早到的识别请求等待就绪
+        // 配置管理对象需要在主线程创建
+        DConfigManager::instance();
+        OCREngine::startWarmUp();
 
         if (cmdParser.isSet(dbusOption)) {
             // 第一调用已 --dbus参数启动
@@ -6,6 +6,8 @@
 #include "view/imageview.h"
 #include "loadingwidget.h"
 #include "frame.h"
+#include "util/log.h"
+#include "engine/scriptdetector.h"
 
 #include <QtCore/QVariant>
 #include <QtWidgets/QApplication>
@@ -15,11 +17,11 @@
 #include <QStandardPaths>
 #include <QFileDialog>
 #include <QFileInfo>
-#include <QThread>
 #include <QMutexLocker>
 #include <QSplitter>
 #include <QTimer>
 #include <QShortcut>
+#include <QFutureWatcher>
 #include <QPushButton>
 
 #include <DGuiApplicationHelper>
@@ -50,17 +52,8 @@ MainWidget::~MainWidget()
 {
     //程序即将结束,线程标志结束
     m_isEndThread = 0;
-    // 等待线程结束
-    if (m_loadImagethread) {
-        m_loadImagethread->requestInterruption(); // 请求线程中断
-        if (!m_loadImagethread->wait(3000)) { // 等待线程结束，超时时间为3秒
-            qWarning() << "OCR thread TIMEOUT";
-            m_loadImagethread->terminate(); // 如果线程没有结束，强制终止线程
-            m_loadImagethread->deleteLater(); // 删除线程对象
-            m_loadImagethread = nullptr;
-        }
-        // 正常结束的情况下delete操作在槽函数中执行
-    }
+    //中断未完成的识别，不再强制结束线程
+    m_recJob.cancel();
 }
 
 void MainWidget::setupUi(QWidget *Widget)
@@ -172,55 +165,73 @@ void MainWidget::setupUi(QWidget *Widget)
     //配置文件读写
     ocrSetting = new QSettings(Dtk::Core::DStandardPaths::writableLocation(QStandardPaths::AppConfigLocation) + "/config.conf", QSettings::IniFormat);
 
-    // 使用 V5 插件时，不显示语言选择控件，只设置一次默认语言
-    if (OCREngine::instance()->isV5()) {
-        OCREngine::instance()->setLanguage("zh-Hans_en");
+    //语种读写设置
+    //目前仅支持默认插件，默认插件支持的语种字符串：zh-Hans_en，zh-Hant_en，en，auto表示识别前自动选择
+    //自动选择每次识别需要额外的探测推理，由用户手动开启
+    auto currentLanguage = ocrSetting->value("language", "zh-Hans_en").toString();
+
+    //设置语种选择框，引擎就绪后根据插件决定是否显示
+    m_recLabel = new DLabel(tr("Recognize language"));
+    m_recLabel->setVisible(false);
+    languageSelectBox = new DComboBox(this);
+    languageSelectBox->setVisible(false);
+    languageSelectBox->setFixedSize(160, 36);
+    languageSelectBox->addItems({tr("Auto detect"), tr("Simplified Chinese"), tr("English"), tr("Traditional Chinese")});
+    static std::map<QString, int> languageIndexMap{ {ScriptDetector::AutoLanguage, 0},
+                                                    {"zh-Hans_en", 1},
+                                                    {"en", 2},
+                                                    {"zh-Hant_en", 3}
+                                                  };
+    if (languageIndexMap.find(currentLanguage) != languageIndexMap.end()) {
+        languageSelectBox->setCurrentIndex(languageIndexMap[currentLanguage]);
     } else {
-        //语种读写设置
-        //目前仅支持默认插件，默认插件支持的语种字符串：zh-Hans_en，zh-Hant_en，en
-        auto currentLanguage = ocrSetting->value("language", "zh-Hans_en").toString();
-        OCREngine::instance()->setLanguage(currentLanguage);
-
-        //设置语种选择框
-        auto recLabel = new DLabel(tr("Recognize language"));
-        languageSelectBox = new DComboBox(this);
-        languageSelectBox->setFixedSize(160, 36);
-        languageSelectBox->addItems({tr("Simplified Chinese"), tr("English"), tr("Traditional Chinese")});
-        static std::map<QString, int> languageIndexMap{ {"zh-Hans_en", 0},
-                                                        {"en", 1},
-                                                        {"zh-Hant_en", 2}
-                                                      };
-        if (languageIndexMap.find(currentLanguage) != languageIndexMap.end()) {
-            languageSelectBox->setCurrentIndex(languageIndexMap[currentLanguage]);
-        } else {
-            languageSelectBox->setCurrentIndex(0);
+        languageSelectBox->setCurrentIndex(1);
+    }
+    connect(languageSelectBox, static_cast<void(DComboBox::*)(int)>(&DComboBox::currentIndexChanged), [this](int index) {
+        QString resultLanguage;
+        switch(index) {
+        default:
+            resultLanguage = "zh-Hans_en";
+            break;
+        case 0:
+            resultLanguage = ScriptDetector::AutoLanguage;
+            break;
+        case 1:
+            resultLanguage = "zh-Hans_en";
+            break;
+        case 2:
+            resultLanguage = "en";
+            break;
+        case 3:
+            resultLanguage = "zh-Hant_en";
+            break;
+        };
+        //自动选择的语言不合适，用户手动切换后需要重新识别
+        if (OCREngine::instance()->language() == ScriptDetector::AutoLanguage && !m_result.isEmpty()) {
+            ScriptDetector::recordOverride();
         }
-        connect(languageSelectBox, static_cast<void(DComboBox::*)(int)>(&DComboBox::currentIndexChanged), [this](int index) {
-            QString resultLanguage;
-            switch(index) {
-            default:
-                resultLanguage = "zh-Hans_en";
-                break;
-            case 0:
-                resultLanguage = "zh-Hans_en";
-                break;
-            case 1:
-                resultLanguage = "en";
-                break;
-            case 2:
-                resultLanguage = "zh-Hant_en";
-                break;
-            };
-            if(!OCREngine::instance()->setLanguage(resultLanguage)) {
-                return;
-            }
-            ocrSetting->setValue("language", resultLanguage);
-            runRec(false);
-            m_noResult->setVisible(false);
-        });
+        if(!OCREngine::instance()->setLanguage(resultLanguage)) {
+            return;
+        }
+        ocrSetting->setValue("language", resultLanguage);
+        runRec(false);
+        m_noResult->setVisible(false);
+    });
+
+    m_buttonHorizontalLayout->addWidget(m_recLabel, 0, Qt::AlignRight);
+    m_buttonHorizontalLayout->addWidget(languageSelectBox, 0, Qt::AlignRight);
 
-        m_buttonHorizontalLayout->addWidget(recLabel, 0, Qt::AlignRight);
-        m_buttonHorizontalLayout->addWidget(languageSelectBox, 0, Qt::AlignRight);
+    //引擎在后台预热时不阻塞界面，就绪后再设置语言并提交识别
+    auto readiness = OCREngine::readiness();
+    if (readiness.isFinished()) {
+        onEngineReady();
+    } else {
+        auto watcher = new QFutureWatcher<void>(this);
+        connect(watcher, &QFutureWatcher<void>::finished, this, [this, watcher]() {
+            watcher->deleteLater();
+            onEngineReady();
+        });
+        watcher->setFuture(readiness);
     }
 
     m_copyBtn = new DIconButton(Widget);
@@ -326,13 +337,18 @@ void MainWidget::setupConnect()
     connect(DGuiApplicationHelper::instance(), &DGuiApplicationHelper::paletteTypeChanged, this, &MainWidget::setIcons);
     connect(m_exportBtn, &DIconButton::clicked, this, &MainWidget::slotExport);
     connect(m_copyBtn, &DIconButton::clicked, this, &MainWidget::slotCopy);
+    //逐段显示先完成的识别结果，全部完成后替换为完整结果
+    connect(OcrScheduler::instance(), &OcrScheduler::jobPartialResult, this, [this](quint64 jobId, const QString &text) {
+        if (!m_recJob.isValid() || jobId != m_recJob.id() || m_recJob.isCancelled()) {
+            return;
+        }
+        m_resultWidget->setCurrentWidget(m_plainTextEdit);
+        m_plainTextEdit->appendPlainText(text);
+    });
     connect(this, &MainWidget::sigResult, this, [ = ](const QString & result) {
+        m_plainTextEdit->clear();
         loadString(result);
         deleteLoadingUi();
-        if(m_needReRunRec) {
-            m_needReRunRec = false;
-            runRec(false);
-        }
     });
 }
 
@@ -439,7 +455,7 @@ bool MainWidget::openImage(const QString &path)
     return bRet;
 }
 
-void MainWidget::openImage(const QImage &img, const QString &name)
+void MainWidget::openImage(const QImage &img, const QString &name, OcrScheduler::Priority priority)
 {
     //新打开的窗口需要设置属性
     DGuiApplicationHelper::ColorType themeType = DGuiApplicationHelper::instance()->themeType();
@@ -465,35 +481,88 @@ void MainWidget::openImage(const QImage &img, const QString &name)
         m_currentImg = nullptr;
     }
     m_currentImg = new QImage(img);
+    m_recRegion = QRect();
+    m_recPriority = priority;
     runRec(true);
 }
 
+void MainWidget::onEngineReady()
+{
+    // 使用 V5 插件时，不显示语言选择控件，只设置一次默认语言
+    if (OCREngine::instance()->isV5()) {
+        OCREngine::instance()->setLanguage("zh-Hans_en");
+    } else {
+        OCREngine::instance()->setLanguage(ocrSetting->value("language", "zh-Hans_en").toString());
+        m_recLabel->setVisible(true);
+        languageSelectBox->setVisible(true);
+    }
+
+    m_engineReady = true;
+    if (m_pendingRec) {
+        m_pendingRec = false;
+        submitRec(m_pendingRecPriority);
+    }
+}
+
 void MainWidget::runRec(bool needSetImage)
 {
-    if(m_loadImagethread && m_loadImagethread->isRunning()) {
-        m_needReRunRec = true;
+    //新的识别开始后，未完成的识别结果已经过时，立即中断，不再等待其完成
+    ++m_recGeneration;
+    if(m_recJob.isValid() && !m_recJob.isFinished()) {
+        qCInfo(dmOcr) << "Preempting stale OCR job" << m_recJob.id() << "generation:" << m_recGeneration;
+        m_recJob.cancel();
+    }
+
+    if(needSetImage || m_recImage.isNull()) {
+        if (!m_currentImg) {
+            qCWarning(dmOcr) << "No image to recognize";
+            return;
+        }
+        m_recImage = *m_currentImg;
+    }
+    //首次识别使用打开窗口时指定的优先级，用户操作触发的重新识别总是交互优先级
+    auto priority = needSetImage ? m_recPriority : OcrScheduler::Interactive;
+    //等待引擎就绪期间只保留最新的图片，就绪后提交一次
+    if (m_pendingRec) {
+        m_pendingRecPriority = qMin(m_pendingRecPriority, priority);
         return;
     }
 
-    createLoadingUi();
+    //中断旧识别时界面仍处于加载状态，不重复创建加载控件
+    if (!m_isLoading) {
+        createLoadingUi();
+    }
     m_plainTextEdit->clear();
-    if(needSetImage) {
-        OCREngine::instance()->setImage(*m_currentImg);
-    }
-    if (!m_loadImagethread) {
-        m_loadImagethread = QThread::create([ = ]() {
-            m_result = OCREngine::instance()->getRecogitionResult();
-            //判断程序是否退出
-            if (1 == m_isEndThread) {
-                emit sigResult(m_result);
-            }
-        });
+    if (!m_engineReady) {
+        m_pendingRec = true;
+        m_pendingRecPriority = priority;
+        return;
     }
-    connect(m_loadImagethread, &QThread::finished, [this](){
-        m_loadImagethread->deleteLater();
-        m_loadImagethread = nullptr;
+    submitRec(priority);
+}
+
+void MainWidget::submitRec(OcrScheduler::Priority priority)
+{
+    //条带拼接的文本与整图识别不同，只有足够高、会按条带识别的图片才流式提交，其余图片的最终文本来自整图识别
+    const QSize recSize = m_recRegion.isNull() ? m_recImage.size() : m_recRegion.size();
+    const bool streaming = OCREngine::streamsImage(recSize);
+    m_recJob = OcrScheduler::instance()->submit(m_recImage, QString(), priority, OcrScheduler::TextResult, m_recRegion,
+                                                streaming);
+    if (!m_recJob.isValid()) {
+        qCWarning(dmOcr) << "Failed to submit OCR job, queue is full";
+        emit sigResult(QString());
+        return;
+    }
+    //回调在界面线程执行，窗口销毁后不再回调
+    //过时的识别即使已经完成也丢弃结果，不更新界面
+    const quint64 generation = m_recGeneration;
+    m_recJob.onFinished(this, [this, generation](const QString &result, bool cancelled) {
+        if (cancelled || 1 != m_isEndThread || generation != m_recGeneration) {
+            return;
+        }
+        m_result = result;
+        emit sigResult(m_result);
     });
-    m_loadImagethread->start();
 }
 
 void MainWidget::loadHtml(const QString &html)
@@ -537,10 +606,6 @@ void MainWidget::loadString(const QString &string)
 
 void MainWidget::resultEmpty()
 {
-    if(m_needReRunRec) {
-        return;
-    }
-
     //修复未识别到文字没有居中对齐的问题
     m_frameStackLayout->setContentsMargins(20, 0, 20, 0);
     m_resultWidget->setCurrentWidget(m_noResult);
@@ -579,6 +644,15 @@ void MainWidget::initScaleLabel()
     hideT->setSingleShot(true);
     connect(hideT, &QTimer::timeout, scalePerc, &DLabel::hide);
 
+    //框选区域后只识别选中的部分，取消框选时恢复整图识别
+    connect(m_imageview, &ImageView::regionSelected, this, [ = ](const QRect &rect) {
+        if (rect == m_recRegion || !m_currentImg) {
+            return;
+        }
+        m_recRegion = rect;
+        runRec(false);
+        m_noResult->setVisible(false);
+    });
     connect(m_imageview, &ImageView::scaled, this, [ = ](qreal perc) {
         label->setText(QString("%1%").arg(int(perc)));
     });
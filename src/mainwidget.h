@@ -21,9 +21,9 @@
 
 #include "textloadwidget.h"
 #include "engine/OCREngine.h"
+#include "engine/ocrscheduler.h"
 
 class Frame;
-class QThread;
 class QGridLayout;
 class QHBoxLayout;
 class ImageView;
@@ -50,7 +50,7 @@ public:
     void initShortcut();
 
     bool openImage(const QString &path);
-    void openImage(const QImage &img, const QString &name = "");
+    void openImage(const QImage &img, const QString &name = "", OcrScheduler::Priority priority = OcrScheduler::Interactive);
 
     void loadHtml(const QString &html);
     void loadString(const QString &string);
@@ -67,6 +67,10 @@ private slots:
     void slotExport();
     void runRec(bool needSetImage);
 private:
+    // 引擎就绪后设置识别语言并提交等待中的识别
+    void onEngineReady();
+    void submitRec(OcrScheduler::Priority priority);
+
     QGridLayout *m_mainGridLayout{nullptr};
     QHBoxLayout *m_horizontalLayout{nullptr};
     ResultTextView *m_plainTextEdit{nullptr};
@@ -93,10 +97,13 @@ private:
 
     bool m_isLoading{false};
 
-    QThread *m_loadImagethread{nullptr};
+    OcrJobHandle m_recJob;  //当前的识别任务
+    OcrScheduler::Priority m_recPriority{OcrScheduler::Interactive};
     QMutex m_mutex;
     QString m_result;
     QImage *m_currentImg{nullptr};
+    QImage m_recImage;  //当前送入识别的图片
+    QRect m_recRegion;  //框选的识别区域(原图坐标)，为空时识别整张图片
 
     DStackedWidget *m_resultWidget{nullptr};
     DLabel *m_noResult{nullptr};
@@ -108,9 +115,13 @@ private:
 
     int m_isEndThread = 1;
     QSettings *ocrSetting;
-    std::atomic_bool m_needReRunRec = false;
+    quint64 m_recGeneration {0};  //识别的代数，每次发起识别加一，旧代数的结果直接丢弃
 
+    DLabel *m_recLabel {nullptr};
     DComboBox *languageSelectBox {nullptr}; // 语言选择框
+    bool m_engineReady {false};
+    bool m_pendingRec {false};  //等待引擎就绪的识别
+    OcrScheduler::Priority m_pendingRecPriority {OcrScheduler::Interactive};
 
 signals:
     void sigResult(const QString &);
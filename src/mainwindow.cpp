@@ -40,9 +40,9 @@ bool MainWindow::openFile(const QString &filePaths)
     return success;
 }
 
-bool MainWindow::openImage(const QImage &image, const QString &name)
+bool MainWindow::openImage(const QImage &image, const QString &name, OcrScheduler::Priority priority)
 {
     qCInfo(dmOcr) << "Opening image in main window, size:" << image.size() << "name:" << name;
-    m_mainWidget->openImage(image, name);
+    m_mainWidget->openImage(image, name, priority);
     return true;
 }
@@ -8,6 +8,8 @@
 #include <DMainWindow>
 #include <QMainWindow>
 
+#include "engine/ocrscheduler.h"
+
 class MainWidget;
 DWIDGET_USE_NAMESPACE
 
@@ -21,7 +23,7 @@ public:
 
     bool openFile(const QString &filePaths);
 
-    bool openImage(const QImage &image,const QString & name="");
+    bool openImage(const QImage &image, const QString &name = "", OcrScheduler::Priority priority = OcrScheduler::Interactive);
 private:
     MainWidget *m_mainWidget{nullptr};
 };
@@ -4,7 +4,7 @@
 
 #include "ocrapplication.h"
 #include "mainwindow.h"
-#include "engine/OCREngine.h"
+#include "engine/ocrscheduler.h"
 #include <DWidgetUtil>
 #include "util/log.h"
 
@@ -17,7 +17,7 @@ bool OcrApplication::openFile(QString filePath)
 {
     qCInfo(dmOcr) << __FUNCTION__ << __LINE__ << filePath;
     bool bRet = false;
-    if (!OCREngine::instance()->isRunning()) {
+    if (!OcrScheduler::instance()->isFull()) {
         MainWindow *win = new MainWindow();
         //增加判断，空图片不会启动
         bRet = win->openFile(filePath);
@@ -33,7 +33,7 @@ bool OcrApplication::openFile(QString filePath)
             qCWarning(dmOcr) << "Failed to open file:" << filePath;
         }
     } else {
-        qCInfo(dmOcr) << "OCR is currently running, cannot open new file";
+        qCInfo(dmOcr) << "OCR queue is full, cannot open new file";
     }
 
     return bRet;
@@ -44,9 +44,9 @@ void OcrApplication::openImage(QImage image)
     //增加判断，空图片不会启动
     if (!image.isNull() && image.width() >= 1) {
         qCInfo(dmOcr) << "Opening image, size:" << image.size();
-        if (!OCREngine::instance()->isRunning()) {
+        if (!OcrScheduler::instance()->isFull()) {
             MainWindow *win = new MainWindow();
-            win->openImage(image);
+            win->openImage(image, "", OcrScheduler::Background);
             win->show();
             //第一次启动才居中
             if (m_loadingCount == 0) {
@@ -55,7 +55,7 @@ void OcrApplication::openImage(QImage image)
                 qCDebug(dmOcr) << "First launch, centering window";
             }
         } else {
-            qCInfo(dmOcr) << "OCR is currently running, cannot open new image";
+            qCInfo(dmOcr) << "OCR queue is full, cannot open new image";
         }
     } else {
         qCWarning(dmOcr) << "Invalid image: null or width < 1";
@@ -67,9 +67,9 @@ void OcrApplication::openImageAndName(QImage image, QString imageName)
     //增加判断，空图片不会启动
     if (!image.isNull() && image.width() >= 1) {
         qCInfo(dmOcr) << "Opening image with name:" << imageName << ", size:" << image.size();
-        if (!OCREngine::instance()->isRunning()) {
+        if (!OcrScheduler::instance()->isFull()) {
             MainWindow *win = new MainWindow();
-            win->openImage(image, imageName);
+            win->openImage(image, imageName, OcrScheduler::Background);
             win->show();
             //第一次启动才居中
             if (m_loadingCount == 0) {
@@ -78,7 +78,7 @@ void OcrApplication::openImageAndName(QImage image, QString imageName)
                 qCDebug(dmOcr) << "First launch, centering window";
             }
         } else {
-            qCInfo(dmOcr) << "OCR is currently running, cannot open new image";
+            qCInfo(dmOcr) << "OCR queue is full, cannot open new image";
         }
     } else {
         qCWarning(dmOcr) << "Invalid image: null or width < 1";
@@ -13,12 +13,28 @@
 #include <QWidget>
 #include <QDebug>
 #include "util/log.h"
+#include "engine/ocrscheduler.h"
+#include "sharedimage.h"
+#include "rawimage.h"
+
+// submit提交的任务结束后最多保留的结果数
+static constexpr int kMaxFinishedJobs = 64;
 
 DbusOcrAdaptor::DbusOcrAdaptor(QObject *parent)
     : QDBusAbstractAdaptor(parent)
 {
     // constructor
     setAutoRelaySignals(true);
+    qDBusRegisterMetaType<OcrResult>();
+    qDBusRegisterMetaType<OcrBatchResult>();
+    qDBusRegisterMetaType<QList<OcrBatchResult>>();
+    //调度器在工作线程中发出信号，转到主线程后发送到总线
+    //只转发通过submit提交的任务，界面等其他任务的识别文本不广播到总线
+    connect(OcrScheduler::instance(), &OcrScheduler::jobPartialResult, this, [this](quint64 jobId, const QString &text) {
+        if (m_jobs.contains(jobId)) {
+            Q_EMIT JobProgress(jobId, text);
+        }
+    }, Qt::QueuedConnection);
 }
 
 DbusOcrAdaptor::~DbusOcrAdaptor()
@@ -33,15 +49,18 @@ bool DbusOcrAdaptor::openFile(QString filePath)
     return true;
 }
 
-void DbusOcrAdaptor::openImageAndName(QByteArray images, QString imageName)
+bool DbusOcrAdaptor::decodeImage(const QByteArray &data, QImage *image)
 {
-    qCInfo(dmOcr) << __FUNCTION__ << __LINE__;
-    QByteArray data = images;
     QString tmp_data = QString::fromLatin1(data.data(), data.size());
     QByteArray srcData = QByteArray::fromBase64(tmp_data.toLatin1());
-    data = qUncompress(srcData);
+    return image->loadFromData(qUncompress(srcData));
+}
+
+void DbusOcrAdaptor::openImageAndName(QByteArray images, QString imageName)
+{
+    qCInfo(dmOcr) << __FUNCTION__ << __LINE__;
     QImage image;
-    if (!image.loadFromData(data)) {
+    if (!decodeImage(images, &image)) {
         qCWarning(dmOcr) << "Failed to load image data for:" << imageName;
         return;
     }
@@ -52,12 +71,8 @@ void DbusOcrAdaptor::openImageAndName(QByteArray images, QString imageName)
 void DbusOcrAdaptor::openImage(QByteArray images)
 {
     qCInfo(dmOcr) << "Opening image via DBus";
-    QByteArray data = images;
-    QString tmp_data = QString::fromLatin1(data.data(), data.size());
-    QByteArray srcData = QByteArray::fromBase64(tmp_data.toLatin1());
-    data = qUncompress(srcData);
     QImage image;
-    if (!image.loadFromData(data)) {
+    if (!decodeImage(images, &image)) {
         qCWarning(dmOcr) << "Failed to load image data";
         return;
     }
@@ -65,3 +80,205 @@ void DbusOcrAdaptor::openImage(QByteArray images)
     QMetaObject::invokeMethod(parent(), "openImage", Q_ARG(QImage, image));
 }
 
+void DbusOcrAdaptor::openImageFd(const QDBusUnixFileDescriptor &fd, int width, int height, int stride, int format)
+{
+    qCInfo(dmOcr) << "Opening image from file descriptor via DBus, size:" << width << "x" << height;
+    if (!fd.isValid()) {
+        sendErrorReply(QDBusError::InvalidArgs, "Invalid file descriptor");
+        return;
+    }
+    QString error;
+    QImage image = SharedImage::fromFd(fd.fileDescriptor(), width, height, stride, format, &error);
+    if (image.isNull()) {
+        qCWarning(dmOcr) << "Failed to load image from file descriptor:" << error;
+        sendErrorReply(QDBusError::InvalidArgs, error);
+        return;
+    }
+    QMetaObject::invokeMethod(parent(), "openImage", Q_ARG(QImage, image));
+}
+
+void DbusOcrAdaptor::openRawImage(const QByteArray &data, int width, int height, int stride, int format, int encoding)
+{
+    qCInfo(dmOcr) << "Opening raw image via DBus, size:" << width << "x" << height << "encoding:" << encoding
+                  << "bytes:" << data.size();
+    QString error;
+    QImage image = RawImage::decode(data, width, height, stride, format, encoding, &error);
+    if (image.isNull()) {
+        qCWarning(dmOcr) << "Failed to load raw image:" << error;
+        sendErrorReply(QDBusError::InvalidArgs, error);
+        return;
+    }
+    QMetaObject::invokeMethod(parent(), "openImage", Q_ARG(QImage, image));
+}
+
+QList<int> DbusOcrAdaptor::rawImageEncodings()
+{
+    return RawImage::supportedEncodings();
+}
+
+QString DbusOcrAdaptor::recognize(const QByteArray &image, const QString &language)
+{
+    qCInfo(dmOcr) << "Headless recognition requested via DBus, language:" << language;
+    replyResult(image, language, QRect(), OcrScheduler::TextResult);
+    return QString();
+}
+
+OcrResult DbusOcrAdaptor::recognizeStructured(const QByteArray &image, const QString &language)
+{
+    qCInfo(dmOcr) << "Structured recognition requested via DBus, language:" << language;
+    replyResult(image, language, QRect(), OcrScheduler::StructuredResult);
+    return OcrResult();
+}
+
+OcrResult DbusOcrAdaptor::recognizeRegion(const QByteArray &image, const QRect &region, const QString &language)
+{
+    qCInfo(dmOcr) << "Region recognition requested via DBus:" << region << "language:" << language;
+    //区域是否在图片内要解码后才知道，由识别任务检查
+    if (region.isEmpty()) {
+        sendErrorReply(QDBusError::InvalidArgs, "Region is empty or outside the image");
+        return OcrResult();
+    }
+    replyResult(image, language, region, OcrScheduler::StructuredResult);
+    return OcrResult();
+}
+
+OcrScheduler::ImageLoader DbusOcrAdaptor::imageLoader(const QByteArray &data)
+{
+    return [data]() {
+        QImage image;
+        if (!decodeImage(data, &image)) {
+            qCWarning(dmOcr) << "Failed to load image data";
+        }
+        return image;
+    };
+}
+
+void DbusOcrAdaptor::replyResult(const QByteArray &image, const QString &language, const QRect &region,
+                                 OcrScheduler::ResultType resultType)
+{
+    OcrJobHandle job = OcrScheduler::instance()->submit(imageLoader(image), language, OcrScheduler::Background, resultType,
+                                                        region);
+    if (!job.isValid()) {
+        sendErrorReply(QDBusError::LimitsExceeded, "OCR queue is full");
+        return;
+    }
+
+    //识别完成后再回复调用方
+    setDelayedReply(true);
+    QDBusMessage request = message();
+    QDBusConnection bus = connection();
+    job.onFinished(this, [job, request, bus, resultType](const QString &result, bool cancelled) {
+        if (cancelled) {
+            bus.send(request.createErrorReply(QDBusError::Failed, "Recognition cancelled"));
+            return;
+        }
+        if (!job.error().isEmpty()) {
+            bus.send(request.createErrorReply(QDBusError::InvalidArgs, job.error()));
+            return;
+        }
+        if (resultType == OcrScheduler::TextResult) {
+            bus.send(request.createReply(result));
+        } else {
+            bus.send(request.createReply(QVariant::fromValue(job.structuredResult())));
+        }
+    });
+}
+
+QList<OcrBatchResult> DbusOcrAdaptor::recognizeFiles(const QStringList &paths, const QString &language)
+{
+    qCInfo(dmOcr) << "Batch recognition requested via DBus, files:" << paths.size();
+    QList<OcrBatchItem> items;
+    items.reserve(paths.size());
+    for (const QString &path : paths) {
+        OcrBatchItem item;
+        item.path = path;
+        items << item;
+    }
+
+    //批量识别作为一个后台任务进入调度队列，与其他任务共享并发限制，完成后再回复调用方
+    OcrJobHandle job = OcrScheduler::instance()->submitBatch(items, language);
+    if (!job.isValid()) {
+        sendErrorReply(QDBusError::LimitsExceeded, "OCR queue is full");
+        return QList<OcrBatchResult>();
+    }
+
+    setDelayedReply(true);
+    QDBusMessage request = message();
+    QDBusConnection bus = connection();
+    //调用方退出总线后没有人接收结果，取消剩余的识别
+    auto watcher = new QDBusServiceWatcher(request.service(), bus, QDBusServiceWatcher::WatchForUnregistration, this);
+    connect(watcher, &QDBusServiceWatcher::serviceUnregistered, this, [job]() mutable {
+        qCInfo(dmOcr) << "Caller left the bus, cancelling batch job" << job.id();
+        job.cancel();
+    });
+    job.onFinished(this, [job, request, bus, watcher](const QString &, bool cancelled) {
+        watcher->deleteLater();
+        if (cancelled) {
+            bus.send(request.createErrorReply(QDBusError::Failed, "Recognition cancelled"));
+            return;
+        }
+        bus.send(request.createReply(QVariant::fromValue(job.batchResults())));
+    });
+    return QList<OcrBatchResult>();
+}
+
+qulonglong DbusOcrAdaptor::submit(const QByteArray &image, const QString &language)
+{
+    //解码在识别任务中进行，这里只入队，立即返回任务ID
+    OcrJobHandle job = OcrScheduler::instance()->submit(imageLoader(image), language, OcrScheduler::Background,
+                                                        OcrScheduler::TextResult, QRect(), true);
+    if (!job.isValid()) {
+        sendErrorReply(QDBusError::LimitsExceeded, "OCR queue is full");
+        return 0;
+    }
+
+    const qulonglong jobId = job.id();
+    m_jobs.insert(jobId, job);
+    job.onFinished(this, [this, job, jobId](const QString &, bool cancelled) {
+        finishJob(jobId, !cancelled && job.error().isEmpty());
+    });
+    qCInfo(dmOcr) << "OCR job" << jobId << "submitted via DBus, in flight:" << m_jobs.size() - m_finishedJobs.size();
+    return jobId;
+}
+
+bool DbusOcrAdaptor::cancel(qulonglong jobId)
+{
+    auto it = m_jobs.find(jobId);
+    if (it == m_jobs.end() || it->isFinished()) {
+        return false;
+    }
+    qCInfo(dmOcr) << "Cancelling OCR job" << jobId << "via DBus";
+    it->cancel();
+    return true;
+}
+
+QString DbusOcrAdaptor::result(qulonglong jobId)
+{
+    auto it = m_jobs.constFind(jobId);
+    if (it == m_jobs.constEnd()) {
+        sendErrorReply(QDBusError::InvalidArgs, "Unknown job id");
+        return QString();
+    }
+    if (!it->isFinished()) {
+        sendErrorReply(QDBusError::Failed, "Job has not finished");
+        return QString();
+    }
+    if (it->isCancelled()) {
+        sendErrorReply(QDBusError::Failed, "Job was cancelled");
+        return QString();
+    }
+    if (!it->error().isEmpty()) {
+        sendErrorReply(QDBusError::Failed, it->error());
+        return QString();
+    }
+    return it->future().result();
+}
+
+void DbusOcrAdaptor::finishJob(qulonglong jobId, bool success)
+{
+    m_finishedJobs.enqueue(jobId);
+    while (m_finishedJobs.size() > kMaxFinishedJobs) {
+        m_jobs.remove(m_finishedJobs.dequeue());
+    }
+    Q_EMIT JobFinished(jobId, success);
+}
@@ -6,7 +6,12 @@
 #define DBUSOCR_ADAPTOR_H
 
 #include <QtCore/QObject>
+#include <QtCore/QHash>
+#include <QtCore/QQueue>
 #include <QtDBus/QtDBus>
+
+#include "engine/ocrresult.h"
+#include "engine/ocrscheduler.h"
 QT_BEGIN_NAMESPACE
 class QByteArray;
 template<class T> class QList;
@@ -18,7 +23,7 @@ QT_END_NAMESPACE
 /*
  * @bref: dbusocr_adaptor 提供给外部程序调用的方法
 */
-class DbusOcrAdaptor: public QDBusAbstractAdaptor
+class DbusOcrAdaptor: public QDBusAbstractAdaptor, protected QDBusContext
 {
     Q_OBJECT
     Q_CLASSINFO("D-Bus Interface", "com.deepin.Ocr")
@@ -34,11 +39,86 @@ class DbusOcrAdaptor: public QDBusAbstractAdaptor
                                        "      <arg direction=\"in\" type=\"s\" name=\"imageName\"/>\n"
                                        "    </method>\n"
 
+                                       "    <method name=\"openImageFd\">\n"
+                                       "      <arg direction=\"in\" type=\"h\" name=\"fd\"/>\n"
+                                       "      <arg direction=\"in\" type=\"i\" name=\"width\"/>\n"
+                                       "      <arg direction=\"in\" type=\"i\" name=\"height\"/>\n"
+                                       "      <arg direction=\"in\" type=\"i\" name=\"stride\"/>\n"
+                                       "      <arg direction=\"in\" type=\"i\" name=\"format\"/>\n"
+                                       "    </method>\n"
+
+                                       "    <method name=\"openRawImage\">\n"
+                                       "      <arg direction=\"in\" type=\"ay\" name=\"data\"/>\n"
+                                       "      <arg direction=\"in\" type=\"i\" name=\"width\"/>\n"
+                                       "      <arg direction=\"in\" type=\"i\" name=\"height\"/>\n"
+                                       "      <arg direction=\"in\" type=\"i\" name=\"stride\"/>\n"
+                                       "      <arg direction=\"in\" type=\"i\" name=\"format\"/>\n"
+                                       "      <arg direction=\"in\" type=\"i\" name=\"encoding\"/>\n"
+                                       "    </method>\n"
+
+                                       "    <method name=\"rawImageEncodings\">\n"
+                                       "      <arg direction=\"out\" type=\"ai\"/>\n"
+                                       "    </method>\n"
+
                                        "    <method name=\"openFile\">\n"
                                        "      <arg direction=\"in\" type=\"s\" name=\"openFile\"/>\n"
                                        "      <arg direction=\"out\" type=\"b\"/>\n"
                                        "    </method>\n"
 
+                                       "    <method name=\"recognize\">\n"
+                                       "      <arg direction=\"in\" type=\"ay\" name=\"image\"/>\n"
+                                       "      <arg direction=\"in\" type=\"s\" name=\"language\"/>\n"
+                                       "      <arg direction=\"out\" type=\"s\"/>\n"
+                                       "    </method>\n"
+
+                                       "    <method name=\"recognizeStructured\">\n"
+                                       "      <arg direction=\"in\" type=\"ay\" name=\"image\"/>\n"
+                                       "      <arg direction=\"in\" type=\"s\" name=\"language\"/>\n"
+                                       "      <arg direction=\"out\" type=\"(sadaiadaii)\"/>\n"
+                                       "      <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"OcrResult\"/>\n"
+                                       "    </method>\n"
+
+                                       "    <method name=\"recognizeRegion\">\n"
+                                       "      <arg direction=\"in\" type=\"ay\" name=\"image\"/>\n"
+                                       "      <arg direction=\"in\" type=\"(iiii)\" name=\"region\"/>\n"
+                                       "      <arg direction=\"in\" type=\"s\" name=\"language\"/>\n"
+                                       "      <arg direction=\"out\" type=\"(sadaiadaii)\"/>\n"
+                                       "      <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"OcrResult\"/>\n"
+                                       "    </method>\n"
+
+                                       "    <method name=\"recognizeFiles\">\n"
+                                       "      <arg direction=\"in\" type=\"as\" name=\"paths\"/>\n"
+                                       "      <arg direction=\"in\" type=\"s\" name=\"language\"/>\n"
+                                       "      <arg direction=\"out\" type=\"a(sbxx)\"/>\n"
+                                       "      <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"QList&lt;OcrBatchResult&gt;\"/>\n"
+                                       "    </method>\n"
+
+                                       "    <method name=\"submit\">\n"
+                                       "      <arg direction=\"in\" type=\"ay\" name=\"image\"/>\n"
+                                       "      <arg direction=\"in\" type=\"s\" name=\"language\"/>\n"
+                                       "      <arg direction=\"out\" type=\"t\"/>\n"
+                                       "    </method>\n"
+
+                                       "    <method name=\"cancel\">\n"
+                                       "      <arg direction=\"in\" type=\"t\" name=\"jobId\"/>\n"
+                                       "      <arg direction=\"out\" type=\"b\"/>\n"
+                                       "    </method>\n"
+
+                                       "    <method name=\"result\">\n"
+                                       "      <arg direction=\"in\" type=\"t\" name=\"jobId\"/>\n"
+                                       "      <arg direction=\"out\" type=\"s\"/>\n"
+                                       "    </method>\n"
+
+                                       "    <signal name=\"JobProgress\">\n"
+                                       "      <arg type=\"t\" name=\"jobId\"/>\n"
+                                       "      <arg type=\"s\" name=\"text\"/>\n"
+                                       "    </signal>\n"
+
+                                       "    <signal name=\"JobFinished\">\n"
+                                       "      <arg type=\"t\" name=\"jobId\"/>\n"
+                                       "      <arg type=\"b\" name=\"success\"/>\n"
+                                       "    </signal>\n"
+
                                        "  </interface>\n")
 public:
     explicit DbusOcrAdaptor(QObject *parent);
@@ -48,9 +128,101 @@ public Q_SLOTS: // METHODS
     void openImage(QByteArray images);
     void openImageAndName(QByteArray images,QString imageName);
 
+    /*
+    * @bref: openImageFd 通过文件描述符传递像素数据打开图片，不需要编码和解码
+    * 已封印(F_SEAL_WRITE|F_SEAL_SHRINK)的memfd直接映射使用，不复制像素
+    * @param: fd 存放像素数据的文件描述符
+    * @param: stride 每行字节数
+    * @param: format 像素格式，取QImage::Format的值
+    */
+    void openImageFd(const QDBusUnixFileDescriptor &fd, int width, int height, int stride, int format);
+
+    /*
+    * @bref: openRawImage 通过字节数组传递像素数据打开图片，不需要PNG编码和base64编码
+    * @param: data 像素数据，按encoding编码
+    * @param: stride 每行字节数
+    * @param: format 像素格式，取QImage::Format的值
+    * @param: encoding 编码方式，取RawImage::Encoding的值，为PNG时忽略宽高、行字节数和格式
+    */
+    void openRawImage(const QByteArray &data, int width, int height, int stride, int format, int encoding);
+
+    // 返回openRawImage支持的编码方式，客户端据此选择编码
+    QList<int> rawImageEncodings();
+
     bool openFile(QString filePath);
 
+    /*
+    * @bref: recognize 识别图片并返回文本，不打开窗口，只经过识别引擎
+    * 图片编码与openImage相同，在识别任务中解码，识别完成后异步回复，不阻塞主线程
+    * @param: language 识别语言，为空时使用默认语言
+    */
+    QString recognize(const QByteArray &image, const QString &language);
+
+    /*
+    * @bref: recognizeStructured 识别图片并返回结构化结果，不打开窗口
+    * 图片编码与openImage相同，在识别任务中解码，识别完成后异步回复，不阻塞主线程
+    * @param: language 识别语言，为空时使用默认语言
+    */
+    OcrResult recognizeStructured(const QByteArray &image, const QString &language);
+
+    /*
+    * @bref: recognizeRegion 只识别图片中的指定区域，返回结构化结果
+    * @param: region 识别区域(x, y, width, height)，为图片坐标；返回的文本框坐标也是整张图片的坐标
+    * @param: language 识别语言，为空时使用默认语言
+    */
+    OcrResult recognizeRegion(const QByteArray &image, const QRect &region, const QString &language);
+
+    /*
+    * @bref: recognizeFiles 批量识别图片文件，不打开窗口
+    * 整批作为后台任务提交到调度器，全部完成后异步回复；调用方退出总线时取消识别
+    * @param: paths 图片文件路径
+    * @param: language 识别语言，为空时使用默认语言
+    * @return: 与paths一一对应的结果(文本、是否成功、解码耗时ms、识别耗时ms)
+    */
+    QList<OcrBatchResult> recognizeFiles(const QStringList &paths, const QString &language);
+
+    /*
+    * @bref: submit 提交异步识别任务，立即返回任务ID，不等待解码和识别
+    * 识别过程中至少发出一次JobProgress，结束后发出JobFinished，再通过result获取文本；
+    * 图片无法解码时JobFinished的success为false
+    * @param: image 图片，编码与openImage相同
+    * @param: language 识别语言，为空时使用默认语言
+    * @return: 任务ID，队列已满时返回错误
+    */
+    qulonglong submit(const QByteArray &image, const QString &language);
+
+    // 取消submit提交的任务，任务不存在或已结束时返回false
+    bool cancel(qulonglong jobId);
+
+    /*
+    * @bref: result 获取submit提交的任务的识别文本
+    * 任务不存在(或结果已被淘汰)、尚未结束或被取消时返回错误
+    */
+    QString result(qulonglong jobId);
+
+private:
+    // 任务结束，记录结果并淘汰最早结束的任务
+    void finishJob(qulonglong jobId, bool success);
+
+    // 提交识别任务，识别完成后异步回复当前D-Bus调用
+    void replyResult(const QByteArray &image, const QString &language, const QRect &region, OcrScheduler::ResultType resultType);
+    // 在识别任务中解码图片数据的函数
+    static OcrScheduler::ImageLoader imageLoader(const QByteArray &data);
+    // 解码openImage等方法使用的图片数据(base64编码的zlib压缩图片文件)
+    static bool decodeImage(const QByteArray &data, QImage *image);
+
 Q_SIGNALS: // SIGNALS
+    // submit提交的任务完成了一部分文本行，按阅读顺序发出；不分条带识别的图片以完整文本发出一次
+    void JobProgress(qulonglong jobId, const QString &text);
+
+    // submit提交的任务结束，success为false表示被取消
+    void JobFinished(qulonglong jobId, bool success);
+
+private:
+    // submit提交的任务，结束后保留到被淘汰，供result获取
+    QHash<qulonglong, OcrJobHandle> m_jobs;
+    // 已结束的任务ID，按结束顺序
+    QQueue<qulonglong> m_finishedJobs;
 };
 
 #endif // DBUSDRAW_ADAPTOR_H
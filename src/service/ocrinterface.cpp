@@ -9,7 +9,9 @@ OcrInterface::OcrInterface(const QString &serviceName, const QString &ObjectPath
                            const QDBusConnection &connection, QObject *parent)
     : QDBusAbstractInterface(serviceName, ObjectPath, staticInterfaceName(), connection, parent)
 {
-
+    qDBusRegisterMetaType<OcrResult>();
+    qDBusRegisterMetaType<OcrBatchResult>();
+    qDBusRegisterMetaType<QList<OcrBatchResult>>();
 }
 
 OcrInterface::~OcrInterface()
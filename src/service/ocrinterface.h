@@ -17,6 +17,12 @@
 #include <QBuffer>
 #include <QDebug>
 
+#include "engine/ocrresult.h"
+#include "sharedimage.h"
+#include "rawimage.h"
+
+#include <unistd.h>
+
 class OcrInterface: public QDBusAbstractInterface
 {
     Q_OBJECT
@@ -56,13 +62,11 @@ public Q_SLOTS: // METHODS
     inline QDBusPendingReply<> openImage(const QImage &image)
     {
         qDebug() << __FUNCTION__;
-        QByteArray data;
-        QBuffer buf(&data);
-        if (image.save(&buf, "PNG")) {
-            data = qCompress(data, 9);
-            data = data.toBase64();
+        //服务端支持openRawImage时直接传递像素，省去PNG编码和压缩
+        if (supportsRawImage()) {
+            return callRawImage(image);
         }
-        return call(QStringLiteral("openImage"), QVariant::fromValue(data));
+        return call(QStringLiteral("openImage"), QVariant::fromValue(encodeImage(image)));
     }
 
     /*
@@ -75,16 +79,159 @@ public Q_SLOTS: // METHODS
     inline QDBusPendingReply<> openImageAndName(const QImage &image, const QString &imageName)
     {
         qDebug() << __FUNCTION__;
+        return call(QStringLiteral("openImageAndName"), QVariant::fromValue(encodeImage(image)), imageName);
+    }
+
+    /*
+    * @bref:openImageFd 通过memfd传递像素打开图片，不做PNG编码、压缩和base64编码
+    * @param: image 图片
+    * @return: QDBusPendingReply，创建memfd失败时返回错误
+    */
+    inline QDBusPendingReply<> openImageFd(const QImage &image)
+    {
+        int fd = SharedImage::toFd(image);
+        if (fd < 0) {
+            return QDBusPendingReply<>(QDBusMessage::createError(QDBusError::Failed, "Failed to create shared memory"));
+        }
+        //QDBusUnixFileDescriptor内部复制描述符，传入后即可关闭
+        QDBusUnixFileDescriptor descriptor(fd);
+        ::close(fd);
+        return asyncCall(QStringLiteral("openImageFd"), QVariant::fromValue(descriptor), image.width(), image.height(),
+                         static_cast<int>(image.bytesPerLine()), static_cast<int>(image.format()));
+    }
+
+    /*
+    * @bref:openRawImage 通过字节数组传递像素打开图片
+    * 按像素数据大小和服务端支持的编码选择直接传递、快速压缩或PNG，服务端不支持时使用openImage
+    * @param: image 图片
+    * @return: QDBusPendingReply
+    */
+    inline QDBusPendingReply<> openRawImage(const QImage &image)
+    {
+        if (!supportsRawImage()) {
+            return call(QStringLiteral("openImage"), QVariant::fromValue(encodeImage(image)));
+        }
+        return callRawImage(image);
+    }
+
+    /*
+    * @bref:recognize 识别图片并返回文本，不打开窗口
+    * @param: image 图片
+    * @param: language 识别语言，为空时使用默认语言
+    * @return: QDBusPendingReply，结果为识别的文本
+    */
+    inline QDBusPendingReply<QString> recognize(const QImage &image, const QString &language = QString())
+    {
+        return asyncCall(QStringLiteral("recognize"), QVariant::fromValue(encodeImage(image)), language);
+    }
+
+    /*
+    * @bref:recognizeStructured 识别图片，不打开窗口
+    * @param: image 图片
+    * @param: language 识别语言，为空时使用默认语言
+    * @return: QDBusPendingReply，结果为文本框位置、文本和置信度
+    */
+    inline QDBusPendingReply<OcrResult> recognizeStructured(const QImage &image, const QString &language = QString())
+    {
+        return asyncCall(QStringLiteral("recognizeStructured"), QVariant::fromValue(encodeImage(image)), language);
+    }
+
+    /*
+    * @bref:recognizeRegion 只识别图片中的指定区域，不打开窗口
+    * @param: image 图片
+    * @param: region 识别区域，图片坐标
+    * @param: language 识别语言，为空时使用默认语言
+    * @return: QDBusPendingReply，文本框坐标为整张图片的坐标
+    */
+    inline QDBusPendingReply<OcrResult> recognizeRegion(const QImage &image, const QRect &region,
+                                                        const QString &language = QString())
+    {
+        return asyncCall(QStringLiteral("recognizeRegion"), QVariant::fromValue(encodeImage(image)), QVariant::fromValue(region),
+                         language);
+    }
+
+    /*
+    * @bref:recognizeFiles 批量识别图片文件，不打开窗口
+    * @param: paths 图片文件路径
+    * @param: language 识别语言，为空时使用默认语言
+    * @return: QDBusPendingReply，与paths一一对应的文本和耗时
+    */
+    inline QDBusPendingReply<QList<OcrBatchResult>> recognizeFiles(const QStringList &paths, const QString &language = QString())
+    {
+        return asyncCall(QStringLiteral("recognizeFiles"), QVariant::fromValue(paths), language);
+    }
+
+    /*
+    * @bref:submit 提交异步识别任务，不等待识别
+    * @param: image 图片
+    * @param: language 识别语言，为空时使用默认语言
+    * @return: QDBusPendingReply，结果为任务ID，任务结束时发出JobFinished
+    */
+    inline QDBusPendingReply<qulonglong> submit(const QImage &image, const QString &language = QString())
+    {
+        return asyncCall(QStringLiteral("submit"), QVariant::fromValue(encodeImage(image)), language);
+    }
+
+    // 取消submit提交的任务
+    inline QDBusPendingReply<bool> cancel(qulonglong jobId)
+    {
+        return asyncCall(QStringLiteral("cancel"), jobId);
+    }
+
+    // 获取submit提交的任务的识别文本，任务未结束或被取消时返回错误
+    inline QDBusPendingReply<QString> result(qulonglong jobId)
+    {
+        return asyncCall(QStringLiteral("result"), jobId);
+    }
+
+Q_SIGNALS: // SIGNALS
+    void JobProgress(qulonglong jobId, const QString &text);
+    void JobFinished(qulonglong jobId, bool success);
+
+private:
+    /*
+    * @bref:encodeImage 按服务端decodeImage的格式编码图片：PNG、qCompress压缩后base64编码
+    * @param: image 图片
+    * @return: 编码后的数据，PNG编码失败时为空
+    */
+    static inline QByteArray encodeImage(const QImage &image)
+    {
         QByteArray data;
         QBuffer buf(&data);
         if (image.save(&buf, "PNG")) {
             data = qCompress(data, 9);
             data = data.toBase64();
         }
-        return call(QStringLiteral("openImageAndName"), QVariant::fromValue(data), imageName);
+        return data;
     }
 
-Q_SIGNALS: // SIGNALS
+    // 服务端是否支持openRawImage，首次使用时查询支持的编码方式
+    inline bool supportsRawImage()
+    {
+        if (!m_rawQueried) {
+            m_rawQueried = true;
+            QDBusReply<QList<int>> reply = call(QStringLiteral("rawImageEncodings"));
+            if (reply.isValid()) {
+                m_rawEncodings = reply.value();
+            } else {
+                qDebug() << "Service does not support raw images:" << reply.error().message();
+            }
+        }
+        return !m_rawEncodings.isEmpty();
+    }
+
+    // 按像素数据大小选择编码方式，通过openRawImage打开图片
+    inline QDBusPendingReply<> callRawImage(const QImage &image)
+    {
+        RawImage::Encoding encoding = RawImage::chooseEncoding(image.bytesPerLine() * image.height(), m_rawEncodings);
+        const QByteArray data = RawImage::encode(image, &encoding);
+        return asyncCall(QStringLiteral("openRawImage"), QVariant::fromValue(data), image.width(), image.height(),
+                         static_cast<int>(image.bytesPerLine()), static_cast<int>(image.format()), static_cast<int>(encoding));
+    }
+
+    // 服务端openRawImage支持的编码方式，首次使用时查询
+    QList<int> m_rawEncodings;
+    bool m_rawQueried = false;
 };
 
 namespace com {
@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "rawimage.h"
+
+#include <QBuffer>
+
+#include <lz4.h>
+
+// 不超过该大小的像素数据直接传递，本机总线上复制比压缩更快
+static constexpr qint64 kMaxUncompressedBytes = 16LL * 1024 * 1024;
+// D-Bus单条消息上限为128MB，留出余量给其他参数
+static constexpr qint64 kMaxPayloadBytes = 120LL * 1024 * 1024;
+
+namespace {
+void releaseBuffer(void *info)
+{
+    delete static_cast<QByteArray *>(info);
+}
+
+// 以data作为像素构造图片，图片释放时才释放data
+QImage wrapPixels(const QByteArray &data, int width, int height, int stride, QImage::Format format)
+{
+    QByteArray *buffer = new QByteArray(data);
+    return QImage(reinterpret_cast<const uchar *>(buffer->constData()), width, height, stride, format, releaseBuffer, buffer);
+}
+
+// 图片的有效像素(stride * height)
+QByteArray pixelBytes(const QImage &image)
+{
+    return QByteArray::fromRawData(reinterpret_cast<const char *>(image.constBits()),
+                                   static_cast<int>(image.bytesPerLine() * image.height()));
+}
+}
+
+QList<int> RawImage::supportedEncodings()
+{
+    return {Raw, Lz4, Zlib, Png};
+}
+
+RawImage::Encoding RawImage::chooseEncoding(qint64 pixelBytes, const QList<int> &peerEncodings)
+{
+    if (pixelBytes <= kMaxUncompressedBytes && peerEncodings.contains(Raw)) {
+        return Raw;
+    }
+    if (peerEncodings.contains(Lz4)) {
+        return Lz4;
+    }
+    if (peerEncodings.contains(Zlib)) {
+        return Zlib;
+    }
+    return Png;
+}
+
+QByteArray RawImage::encode(const QImage &image, Encoding *encoding)
+{
+    QByteArray data;
+    const QByteArray pixels = pixelBytes(image);
+    switch (*encoding) {
+    case Raw:
+        //fromRawData不复制，这里复制一次作为消息内容
+        data = QByteArray(pixels.constData(), pixels.size());
+        break;
+    case Lz4:
+        data.resize(LZ4_compressBound(pixels.size()));
+        data.resize(LZ4_compress_default(pixels.constData(), data.data(), pixels.size(), data.size()));
+        break;
+    case Zlib:
+        data = qCompress(pixels, 1);
+        break;
+    case Png:
+        break;
+    }
+
+    if (*encoding == Png || data.isEmpty() || data.size() > kMaxPayloadBytes) {
+        *encoding = Png;
+        data.clear();
+        QBuffer buffer(&data);
+        image.save(&buffer, "PNG");
+    }
+    return data;
+}
+
+QImage RawImage::decode(const QByteArray &data, int width, int height, int stride, int format, int encoding, QString *error)
+{
+    if (encoding == Png) {
+        QImage image;
+        if (!image.loadFromData(data, "PNG")) {
+            *error = "Failed to decode PNG data";
+        }
+        return image;
+    }
+
+    if (width <= 0 || height <= 0 || format <= QImage::Format_Invalid || format >= QImage::NImageFormats) {
+        *error = "Invalid image geometry or format";
+        return QImage();
+    }
+    const QImage::Format imageFormat = static_cast<QImage::Format>(format);
+    const qint64 minStride = (static_cast<qint64>(width) * QImage::toPixelFormat(imageFormat).bitsPerPixel() + 7) / 8;
+    const qint64 length = static_cast<qint64>(stride) * height;
+    if (stride < minStride || length > kMaxPayloadBytes * 4) {
+        *error = "Invalid stride";
+        return QImage();
+    }
+
+    QByteArray pixels;
+    switch (encoding) {
+    case Raw:
+        pixels = data;
+        break;
+    case Lz4:
+        pixels.resize(static_cast<int>(length));
+        if (LZ4_decompress_safe(data.constData(), pixels.data(), data.size(), pixels.size()) != length) {
+            pixels.clear();
+        }
+        break;
+    case Zlib:
+        pixels = qUncompress(data);
+        break;
+    default:
+        *error = "Unknown encoding";
+        return QImage();
+    }
+
+    if (pixels.size() < length) {
+        *error = "Pixel data is smaller than the image";
+        return QImage();
+    }
+    return wrapPixels(pixels, width, height, stride, imageFormat);
+}
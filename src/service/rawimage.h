@@ -0,0 +1,54 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef RAWIMAGE_H
+#define RAWIMAGE_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QList>
+#include <QString>
+
+/*
+ * @bref: RawImage 通过D-Bus字节数组传递像素数据的编码
+ * 本机调用时直接传递像素比PNG编码加zlib压缩快得多；数据较大时用快速压缩减小消息，
+ * 超出D-Bus消息大小限制时才使用PNG
+*/
+class RawImage
+{
+public:
+    // 像素数据的编码方式，数值用于D-Bus传输
+    enum Encoding {
+        Raw = 0,    // 未压缩的像素
+        Lz4 = 1,    // LZ4快速压缩的像素
+        Zlib = 2,   // zlib(级别1)压缩的像素，对方不支持LZ4时使用
+        Png = 3     // PNG文件，宽高、行字节数和格式以文件为准
+    };
+
+    // 本进程支持的编码方式
+    static QList<int> supportedEncodings();
+
+    /*
+    * @bref: chooseEncoding 按像素数据大小和对方支持的编码选择编码方式
+    * 较小的数据直接传递，较大的数据快速压缩，超出消息大小限制时使用PNG
+    */
+    static Encoding chooseEncoding(qint64 pixelBytes, const QList<int> &peerEncodings);
+
+    // 按指定方式编码图片，压缩后仍超出消息大小限制时改用PNG，encoding输出实际使用的方式
+    static QByteArray encode(const QImage &image, Encoding *encoding);
+
+    /*
+    * @bref: decode 解码像素数据
+    * 未压缩的数据直接作为图片的像素使用，不复制
+    * @param: stride 每行字节数
+    * @param: format QImage::Format的值
+    * @param: error 失败时输出原因
+    */
+    static QImage decode(const QByteArray &data, int width, int height, int stride, int format, int encoding, QString *error);
+
+private:
+    RawImage() = delete;
+};
+
+#endif // RAWIMAGE_H
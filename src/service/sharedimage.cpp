@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "sharedimage.h"
+#include "util/log.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// 接收方直接映射需要的封印：内容不可写、文件不可缩小
+static constexpr int kRequiredSeals = F_SEAL_WRITE | F_SEAL_SHRINK;
+
+namespace {
+struct Mapping {
+    void *address;
+    size_t length;
+};
+
+void unmapImage(void *info)
+{
+    Mapping *mapping = static_cast<Mapping *>(info);
+    munmap(mapping->address, mapping->length);
+    delete mapping;
+}
+}
+
+QImage SharedImage::fromFd(int fd, int width, int height, int stride, int format, QString *error)
+{
+    if (width <= 0 || height <= 0 || format <= QImage::Format_Invalid || format >= QImage::NImageFormats) {
+        *error = "Invalid image geometry or format";
+        return QImage();
+    }
+    const QImage::Format imageFormat = static_cast<QImage::Format>(format);
+    const qint64 minStride = (static_cast<qint64>(width) * QImage::toPixelFormat(imageFormat).bitsPerPixel() + 7) / 8;
+    if (stride < minStride) {
+        *error = "Stride is smaller than one row of pixels";
+        return QImage();
+    }
+    const size_t length = static_cast<size_t>(stride) * static_cast<size_t>(height);
+
+    //映射前检查文件大小，映射超出文件末尾的部分在访问时会产生SIGBUS
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < 0 || static_cast<size_t>(info.st_size) < length) {
+        *error = "File descriptor is smaller than the image data";
+        return QImage();
+    }
+
+    const int seals = fcntl(fd, F_GET_SEALS);
+    if (seals < 0 || (seals & kRequiredSeals) != kRequiredSeals) {
+        //发送方仍可修改或缩小文件，映射后访问可能产生SIGBUS，逐行读取一份副本
+        qCInfo(dmOcr) << "Shared image is not sealed, copying pixels";
+        QImage image(width, height, imageFormat);
+        if (image.isNull()) {
+            *error = "Failed to allocate image";
+            return QImage();
+        }
+        for (int y = 0; y < height; ++y) {
+            const off_t offset = static_cast<off_t>(y) * stride;
+            if (pread(fd, image.scanLine(y), static_cast<size_t>(minStride), offset) != minStride) {
+                *error = "Failed to read image data";
+                return QImage();
+            }
+        }
+        return image;
+    }
+
+    void *address = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) {
+        *error = "Failed to map file descriptor";
+        return QImage();
+    }
+    //只读的映射以const数据构造图片，修改时Qt会自动复制
+    QImage image(static_cast<const uchar *>(address), width, height, stride, imageFormat, unmapImage,
+                 new Mapping {address, length});
+    qCInfo(dmOcr) << "Shared image mapped without copy, size:" << image.size() << "format:" << imageFormat;
+    return image;
+}
+
+int SharedImage::toFd(const QImage &image)
+{
+    if (image.isNull()) {
+        return -1;
+    }
+    int fd = memfd_create("deepin-ocr-image", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0) {
+        qCWarning(dmOcr) << "Failed to create memfd";
+        return -1;
+    }
+
+    const qint64 length = image.sizeInBytes();
+    if (ftruncate(fd, length) != 0) {
+        close(fd);
+        return -1;
+    }
+    const uchar *data = image.constBits();
+    qint64 written = 0;
+    while (written < length) {
+        ssize_t result = write(fd, data + written, static_cast<size_t>(length - written));
+        if (result <= 0) {
+            close(fd);
+            return -1;
+        }
+        written += result;
+    }
+
+    if (fcntl(fd, F_ADD_SEALS, kRequiredSeals | F_SEAL_GROW | F_SEAL_SEAL) != 0) {
+        qCWarning(dmOcr) << "Failed to seal memfd";
+    }
+    return fd;
+}
@@ -0,0 +1,40 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SHAREDIMAGE_H
+#define SHAREDIMAGE_H
+
+#include <QImage>
+#include <QString>
+
+/*
+ * @bref: SharedImage 通过文件描述符(memfd)在进程间传递图片像素
+ * 发送方把像素写入memfd并加上封印，接收方直接映射使用，不需要编码、解码和复制
+*/
+class SharedImage
+{
+public:
+    /*
+    * @bref: fromFd 映射文件描述符中的像素数据为图片
+    * 已封印禁止写入和缩小的memfd直接只读映射，图片释放时解除映射；
+    * 未封印的描述符内容可能被发送方修改，读取一份副本
+    * @param: fd 文件描述符，只在调用期间使用，调用方仍需自行关闭
+    * @param: stride 每行字节数
+    * @param: format QImage::Format的值
+    * @param: error 失败时输出原因
+    * @return: 图片，参数无效或映射失败时返回空图片
+    */
+    static QImage fromFd(int fd, int width, int height, int stride, int format, QString *error);
+
+    /*
+    * @bref: toFd 将图片像素写入新建的memfd并封印
+    * @return: 文件描述符，调用方负责关闭，失败时返回-1
+    */
+    static int toFd(const QImage &image);
+
+private:
+    SharedImage() = delete;
+};
+
+#endif // SHAREDIMAGE_H
@@ -10,6 +10,18 @@
 
 #define COMMON_GROUP "deepin-ocr.common"
 #define COMMON_ISGPUENABLE "IsGpuEnable"
+#define COMMON_ENGINEPOOLSIZE "EnginePoolSize"
+#define COMMON_MAXQUEUEDEPTH "MaxQueueDepth"
+#define COMMON_OCRTHREADCOUNT "OcrThreadCount"
+#define COMMON_RESULTCACHESIZE "ResultCacheSize"
+#define COMMON_DISKCACHESIZE "DiskCacheSize"
+#define COMMON_TILESIZE "TileSize"
+#define COMMON_TILEOVERLAP "TileOverlap"
+#define COMMON_TARGETTEXTHEIGHT "TargetTextHeight"
+#define COMMON_HARDWAREPROBECACHE "HardwareProbeCache"
+#define COMMON_LANGUAGEENGINEMEMORY "LanguageEngineMemory"
+#define COMMON_AUTOORIENTATION "AutoOrientation"
+#define COMMON_FRAMEDEDUPLICATION "FrameDeduplication"
 
 class DConfigManagerPrivate;
 class DConfigManager : public QObject
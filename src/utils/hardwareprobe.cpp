@@ -0,0 +1,206 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "hardwareprobe.h"
+#include "dconfigmanager.h"
+#include "util/log.h"
+
+#include <QDir>
+#include <QFile>
+#include <QSet>
+#include <QPair>
+#include <QJsonDocument>
+#include <QSysInfo>
+#include <QMetaObject>
+
+#include <unistd.h>
+
+namespace {
+// 读取/proc/cpuinfo中"key : value"格式的一行
+bool parseCpuInfoLine(const QByteArray &line, QByteArray *key, QByteArray *value)
+{
+    int colon = line.indexOf(':');
+    if (colon < 0) {
+        return false;
+    }
+    *key = line.left(colon).trimmed();
+    *value = line.mid(colon + 1).trimmed();
+    return true;
+}
+
+QByteArray readSysFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return QByteArray();
+    }
+    return file.readAll().trimmed();
+}
+
+QStringList listDevices(const QString &dir, const QString &pattern)
+{
+    QStringList result;
+    //设备节点是字符设备，需要QDir::System才能列出
+    const QStringList names = QDir(dir).entryList({pattern}, QDir::System | QDir::Files, QDir::Name);
+    for (const QString &name : names) {
+        result << dir + "/" + name;
+    }
+    return result;
+}
+}
+
+bool HardwareInfo::hasMtGpu() const
+{
+    for (const QString &device : gpuDevices) {
+        if (device.startsWith("/dev/mtgpu")) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QJsonObject HardwareInfo::toJson() const
+{
+    QJsonObject json;
+    json.insert("identity", identity);
+    json.insert("cpuModel", cpuModel);
+    json.insert("logicalCpus", logicalCpus);
+    json.insert("physicalCores", physicalCores);
+    return json;
+}
+
+HardwareInfo HardwareInfo::fromJson(const QJsonObject &json)
+{
+    HardwareInfo info;
+    info.identity = json.value("identity").toString();
+    info.cpuModel = json.value("cpuModel").toString();
+    info.logicalCpus = json.value("logicalCpus").toInt();
+    info.physicalCores = json.value("physicalCores").toInt();
+    return info;
+}
+
+const HardwareInfo &HardwareProbe::info()
+{
+    static const HardwareInfo hardwareInfo = load();
+    return hardwareInfo;
+}
+
+QString HardwareProbe::currentIdentity(QString *cpuModel)
+{
+    QByteArray model;
+    QByteArray implementer;
+    QByteArray part;
+    QFile cpuinfo("/proc/cpuinfo");
+    if (cpuinfo.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        bool started = false;
+        while (!cpuinfo.atEnd()) {
+            QByteArray line = cpuinfo.readLine();
+            //只读第一个处理器，空行表示处理器信息结束
+            if (line.trimmed().isEmpty()) {
+                if (started) {
+                    break;
+                }
+                continue;
+            }
+            started = true;
+            QByteArray key;
+            QByteArray value;
+            if (!parseCpuInfoLine(line, &key, &value)) {
+                continue;
+            }
+            if (key == "model name") {
+                model = value;
+            } else if (key == "CPU implementer") {
+                implementer = value;
+            } else if (key == "CPU part") {
+                part = value;
+            }
+        }
+    }
+    // ARM平台没有型号名称，使用厂商和型号编码
+    if (model.isEmpty() && !implementer.isEmpty()) {
+        model = implementer + ":" + part;
+    }
+    *cpuModel = QString::fromUtf8(model);
+
+    return QStringList {QSysInfo::kernelVersion(), QSysInfo::currentCpuArchitecture(), *cpuModel,
+                        QString::number(sysconf(_SC_NPROCESSORS_CONF))}.join('|');
+}
+
+HardwareInfo HardwareProbe::probe(const QString &identity, const QString &cpuModel)
+{
+    HardwareInfo info;
+    info.identity = identity;
+    info.cpuModel = cpuModel;
+
+    QSet<QPair<QByteArray, QByteArray>> cores;
+    QFile cpuinfo("/proc/cpuinfo");
+    if (cpuinfo.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QByteArray physicalId;
+        while (!cpuinfo.atEnd()) {
+            QByteArray key;
+            QByteArray value;
+            if (!parseCpuInfoLine(cpuinfo.readLine(), &key, &value)) {
+                continue;
+            }
+            if (key == "processor") {
+                ++info.logicalCpus;
+            } else if (key == "physical id") {
+                physicalId = value;
+            } else if (key == "core id") {
+                cores.insert(qMakePair(physicalId, value));
+            }
+        }
+    }
+    if (info.logicalCpus <= 0) {
+        info.logicalCpus = static_cast<int>(qMax(1L, sysconf(_SC_NPROCESSORS_CONF)));
+    }
+
+    //cpuinfo中没有拓扑信息时(ARM等)从sysfs读取
+    if (cores.isEmpty()) {
+        for (int cpu = 0; cpu < info.logicalCpus; ++cpu) {
+            const QString dir = QString("/sys/devices/system/cpu/cpu%1/topology/").arg(cpu);
+            QByteArray coreId = readSysFile(dir + "core_id");
+            if (!coreId.isEmpty()) {
+                cores.insert(qMakePair(readSysFile(dir + "physical_package_id"), coreId));
+            }
+        }
+    }
+    info.physicalCores = cores.isEmpty() ? info.logicalCpus : qMin(cores.size(), info.logicalCpus);
+    return info;
+}
+
+QStringList HardwareProbe::gpuDevices()
+{
+    return listDevices("/dev/dri", "renderD*") << listDevices("/dev", "mtgpu.*");
+}
+
+HardwareInfo HardwareProbe::load()
+{
+    QString cpuModel;
+    const QString identity = currentIdentity(&cpuModel);
+
+    //硬件标识未变化时使用上次的探测结果
+    const QString cached = DConfigManager::instance()->value(COMMON_GROUP, COMMON_HARDWAREPROBECACHE, QString()).toString();
+    const QJsonObject json = QJsonDocument::fromJson(cached.toUtf8()).object();
+    if (!json.isEmpty() && json.value("identity").toString() == identity) {
+        HardwareInfo info = HardwareInfo::fromJson(json);
+        //GPU和驱动可能在硬件标识不变时增删，设备节点每次启动重新列出
+        info.gpuDevices = gpuDevices();
+        qCInfo(dmOcr) << "Hardware capabilities loaded from cache:" << info.cpuModel << "gpu devices:" << info.gpuDevices;
+        return info;
+    }
+
+    HardwareInfo info = probe(identity, cpuModel);
+    info.gpuDevices = gpuDevices();
+    qCInfo(dmOcr) << "Hardware probed, cpu:" << info.cpuModel << "logical cpus:" << info.logicalCpus
+                  << "physical cores:" << info.physicalCores << "gpu devices:" << info.gpuDevices;
+
+    //DConfig对象属于主线程，探测可能在后台线程进行，写入放到主线程执行
+    const QString data = QString::fromUtf8(QJsonDocument(info.toJson()).toJson(QJsonDocument::Compact));
+    QMetaObject::invokeMethod(DConfigManager::instance(), [data]() {
+        DConfigManager::instance()->setValue(COMMON_GROUP, COMMON_HARDWAREPROBECACHE, data);
+    }, Qt::QueuedConnection);
+    return info;
+}
@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef HARDWAREPROBE_H
+#define HARDWAREPROBE_H
+
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+
+/*
+ * @bref: HardwareInfo 硬件能力探测结果
+*/
+struct HardwareInfo {
+    QString identity;       // 内核版本、CPU架构和型号，硬件或系统变化时不同
+    QString cpuModel;
+    int logicalCpus {0};    // 逻辑CPU个数
+    int physicalCores {0};  // 物理核心个数，无法获取时与逻辑CPU个数相同
+    QStringList gpuDevices; // GPU设备节点，每次启动重新列出，不缓存
+
+    // 是否存在摩尔线程GPU
+    bool hasMtGpu() const;
+    QJsonObject toJson() const;
+    static HardwareInfo fromJson(const QJsonObject &json);
+};
+
+/*
+ * @bref: HardwareProbe 探测CPU型号、核心拓扑和GPU设备
+ * 直接解析/proc/cpuinfo，CPU信息按硬件标识缓存在DConfig中，标识未变化时后续启动直接使用缓存；
+ * 硬件标识不包含GPU，GPU设备节点每次启动重新列出
+*/
+class HardwareProbe
+{
+public:
+    // 本进程内只探测一次，可在任意线程调用
+    static const HardwareInfo &info();
+
+private:
+    // 读取/proc/cpuinfo第一个处理器的信息计算标识，比完整探测开销小
+    static QString currentIdentity(QString *cpuModel);
+    static HardwareInfo probe(const QString &identity, const QString &cpuModel);
+    // 列出GPU设备节点，只是目录扫描
+    static QStringList gpuDevices();
+    static HardwareInfo load();
+    HardwareProbe() = delete;
+};
+
+#endif // HARDWAREPROBE_H
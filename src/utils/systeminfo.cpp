@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "systeminfo.h"
+
+#include <QFile>
+#include <QByteArray>
+#include <QThread>
+
+#include <link.h>
+#include <sched.h>
+#include <cmath>
+
+qint64 SystemInfo::availableMemory()
+{
+    // /proc下的文件大小为0，只能逐行读取
+    QFile meminfo("/proc/meminfo");
+    if (!meminfo.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return -1;
+    }
+
+    while (!meminfo.atEnd()) {
+        QByteArray line = meminfo.readLine();
+        if (!line.startsWith("MemAvailable:")) {
+            continue;
+        }
+        // 格式: "MemAvailable:   12345678 kB"
+        QList<QByteArray> fields = line.simplified().split(' ');
+        if (fields.size() < 2) {
+            return -1;
+        }
+        bool ok = false;
+        qint64 kb = fields.at(1).toLongLong(&ok);
+        return ok ? kb * 1024 : -1;
+    }
+    return -1;
+}
+
+int SystemInfo::availableCpuCount()
+{
+    int count = 0;
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+        count = CPU_COUNT(&mask);
+    }
+    if (count <= 0) {
+        count = QThread::idealThreadCount();
+    }
+
+    int limit = cgroupCpuLimit();
+    if (limit > 0 && limit < count) {
+        count = limit;
+    }
+    return qMax(1, count);
+}
+
+int SystemInfo::cgroupCpuLimit()
+{
+    auto readFile = [](const QString &path) -> QByteArray {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            return QByteArray();
+        }
+        return file.readAll().trimmed();
+    };
+    auto quotaToCpus = [](double quota, double period) -> int {
+        if (quota <= 0 || period <= 0) {
+            return -1;
+        }
+        return qMax(1, static_cast<int>(std::ceil(quota / period)));
+    };
+
+    //查找本进程所在的cgroup路径，容器中通常挂载为根目录
+    QString v2Path;
+    QString v1Path;
+    QFile cgroup("/proc/self/cgroup");
+    if (cgroup.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        while (!cgroup.atEnd()) {
+            // 格式: "hierarchy-ID:controller-list:cgroup-path"
+            QList<QByteArray> fields = cgroup.readLine().trimmed().split(':');
+            if (fields.size() < 3) {
+                continue;
+            }
+            if (fields.at(0) == "0" && fields.at(1).isEmpty()) {
+                v2Path = QString::fromUtf8(fields.at(2));
+            } else if (fields.at(1).split(',').contains("cpu")) {
+                v1Path = QString::fromUtf8(fields.at(2));
+            }
+        }
+    }
+
+    // cgroup v2: cpu.max 内容为 "$MAX $PERIOD"，不限制时为 "max $PERIOD"
+    for (const QString &dir : {"/sys/fs/cgroup" + v2Path, QString("/sys/fs/cgroup")}) {
+        QList<QByteArray> fields = readFile(dir + "/cpu.max").split(' ');
+        if (fields.size() == 2) {
+            if (fields.at(0) == "max") {
+                return -1;
+            }
+            return quotaToCpus(fields.at(0).toDouble(), fields.at(1).toDouble());
+        }
+    }
+
+    // cgroup v1: 不限制时cpu.cfs_quota_us为-1
+    for (const QString &dir : {"/sys/fs/cgroup/cpu" + v1Path, QString("/sys/fs/cgroup/cpu"),
+                               "/sys/fs/cgroup/cpu,cpuacct" + v1Path, QString("/sys/fs/cgroup/cpu,cpuacct")}) {
+        QByteArray quota = readFile(dir + "/cpu.cfs_quota_us");
+        QByteArray period = readFile(dir + "/cpu.cfs_period_us");
+        if (!quota.isEmpty() && !period.isEmpty()) {
+            return quotaToCpus(quota.toDouble(), period.toDouble());
+        }
+    }
+    return -1;
+}
+
+QStringList SystemInfo::loadedLibraries()
+{
+    QStringList libraries;
+    dl_iterate_phdr([](struct dl_phdr_info *info, size_t, void *data) -> int {
+        //主程序和vdso的名称为空
+        if (info->dlpi_name && info->dlpi_name[0] != '\0') {
+            static_cast<QStringList *>(data)->append(QString::fromLocal8Bit(info->dlpi_name));
+        }
+        return 0;
+    }, &libraries);
+    return libraries;
+}
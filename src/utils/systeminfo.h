@@ -0,0 +1,39 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SYSTEMINFO_H
+#define SYSTEMINFO_H
+
+#include <QtGlobal>
+#include <QStringList>
+
+/*
+ * @bref: SystemInfo 读取运行环境的资源信息，用于决定OCR引擎的资源占用
+*/
+class SystemInfo
+{
+public:
+    /*
+    * @bref: availableMemory 当前可用内存，读取/proc/meminfo的MemAvailable
+    * @return: 可用内存字节数，读取失败返回-1
+    */
+    static qint64 availableMemory();
+
+    /*
+    * @bref: availableCpuCount 当前进程实际可用的CPU个数
+    * 取sched亲和性掩码中的CPU个数，并受cgroup CPU配额限制(容器环境)
+    * @return: 可用CPU个数，至少为1
+    */
+    static int availableCpuCount();
+
+    // 当前进程已加载的共享库路径
+    static QStringList loadedLibraries();
+
+private:
+    // cgroup CPU配额折算的CPU个数，未限制返回-1
+    static int cgroupCpuLimit();
+    SystemInfo() = delete;
+};
+
+#endif // SYSTEMINFO_H
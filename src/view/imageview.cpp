@@ -7,6 +7,8 @@
 
 #include <QPaintDevice>
 #include <QGraphicsPixmapItem>
+#include <QGraphicsRectItem>
+#include <QPen>
 #include <QDebug>
 #include <QDragEnterEvent>
 #include <QMimeData>
@@ -57,6 +59,7 @@ void ImageView::openImage(const QString &path)
             qCDebug(dmOcr) << "Image loaded successfully, size:" << m_currentImage->size();
 
             scene()->clear();
+            m_selectionItem = nullptr;
             m_pixmapItem = new QGraphicsPixmapItem(pic);
             m_pixmapItem->setTransformationMode(Qt::SmoothTransformation);
             QRectF rect = m_pixmapItem->boundingRect();
@@ -80,6 +83,7 @@ void ImageView::openFilterImage(QImage img)
     QPixmap pic = QPixmap::fromImage(img);
     if (!pic.isNull()) {
         scene()->clear();
+        m_selectionItem = nullptr;
         m_pixmapItem = new QGraphicsPixmapItem(pic);
         m_pixmapItem->setTransformationMode(Qt::SmoothTransformation);
         QRectF rect = m_pixmapItem->boundingRect();
@@ -138,7 +142,10 @@ void ImageView::RotateImage(const int &index)
 
     pixmap = pixmap.transformed(rotate, Qt::FastTransformation);
     pixmap.setDevicePixelRatio(devicePixelRatioF());
+    //框选区域按原图坐标记录，旋转后只需要重新显示，直接清除
+    bool hadSelection = m_selectionItem != nullptr;
     scene()->clear();
+    m_selectionItem = nullptr;
     resetTransform();
     m_pixmapItem = new QGraphicsPixmapItem(pixmap);
     m_pixmapItem->setTransformationMode(Qt::SmoothTransformation);
@@ -152,6 +159,37 @@ void ImageView::RotateImage(const int &index)
     qCDebug(dmOcr) << "Image rotation completed, total angle:" << m_rotateAngel;
 
     m_FilterImage = image();
+    if (hadSelection) {
+        emit regionSelected(QRect());
+    }
+}
+
+void ImageView::clearSelection()
+{
+    if (m_selectionItem) {
+        delete m_selectionItem;
+        m_selectionItem = nullptr;
+    }
+    m_isSelecting = false;
+}
+
+QRect ImageView::sourceRect(const QRectF &sceneRect) const
+{
+    //图片项的坐标为逻辑像素，乘以设备像素比得到显示图片的像素坐标
+    const QPixmap pixmap = m_pixmapItem->pixmap();
+    const qreal ratio = pixmap.devicePixelRatio();
+    QRectF rect = m_pixmapItem->mapRectFromScene(sceneRect).intersected(m_pixmapItem->boundingRect());
+    rect = QRectF(rect.topLeft() * ratio, rect.size() * ratio);
+
+    //显示的图片由原图旋转得到，按旋转前的尺寸求出旋转变换后取逆
+    QSize size = pixmap.size();
+    if (qAbs(m_rotateAngel) % 180 == 90) {
+        size.transpose();
+    }
+    QTransform rotate;
+    rotate.rotate(m_rotateAngel);
+    const QTransform toSource = QImage::trueMatrix(rotate, size.width(), size.height()).inverted();
+    return toSource.mapRect(rect).toAlignedRect().intersected(QRect(QPoint(0, 0), size));
 }
 
 
@@ -196,12 +234,45 @@ void ImageView::autoFit()
 
 void ImageView::mouseReleaseEvent(QMouseEvent *e)
 {
+    if (m_isSelecting) {
+        m_isSelecting = false;
+        viewport()->setCursor(Qt::ArrowCursor);
+        //框选区域过小视为单击，取消框选恢复整图识别
+        QRect rect;
+        if (m_selectionItem) {
+            QRectF selected = m_selectionItem->rect();
+            QSizeF viewSize = transform().mapRect(selected).size();
+            if (viewSize.width() >= 4 && viewSize.height() >= 4) {
+                rect = sourceRect(m_pixmapItem->mapRectToScene(selected));
+            }
+        }
+        if (rect.isEmpty()) {
+            clearSelection();
+        }
+        qCInfo(dmOcr) << "Region selected:" << rect;
+        emit regionSelected(rect);
+        return;
+    }
     QGraphicsView::mouseReleaseEvent(e);
     viewport()->setCursor(Qt::ArrowCursor);
 }
 
 void ImageView::mousePressEvent(QMouseEvent *e)
 {
+    //按住Ctrl拖动时框选识别区域，否则拖动图片
+    if (m_pixmapItem && e->button() == Qt::LeftButton && (e->modifiers() & Qt::ControlModifier)) {
+        clearSelection();
+        m_isSelecting = true;
+        m_selectionOrigin = m_pixmapItem->mapFromScene(mapToScene(e->pos()));
+        m_selectionItem = new QGraphicsRectItem(QRectF(m_selectionOrigin, QSizeF()), m_pixmapItem);
+        QPen pen(QColor(0, 129, 255));
+        pen.setCosmetic(true);
+        pen.setWidth(2);
+        m_selectionItem->setPen(pen);
+        m_selectionItem->setBrush(QColor(0, 129, 255, 40));
+        viewport()->setCursor(Qt::CrossCursor);
+        return;
+    }
     QGraphicsView::mousePressEvent(e);
     viewport()->unsetCursor();
     viewport()->setCursor(Qt::ArrowCursor);
@@ -209,6 +280,13 @@ void ImageView::mousePressEvent(QMouseEvent *e)
 
 void ImageView::mouseMoveEvent(QMouseEvent *event)
 {
+    if (m_isSelecting) {
+        if (m_selectionItem) {
+            QPointF pos = m_pixmapItem->mapFromScene(mapToScene(event->pos()));
+            m_selectionItem->setRect(QRectF(m_selectionOrigin, pos).normalized().intersected(m_pixmapItem->boundingRect()));
+        }
+        return;
+    }
     //修复鼠标状态不对的问题
     if (!(event->buttons() | Qt::NoButton)) {
         viewport()->setCursor(Qt::ArrowCursor);
@@ -11,6 +11,7 @@
 #include <QGraphicsView>
 
 class QGraphicsPixmapItem;
+class QGraphicsRectItem;
 class QGestureEvent;
 class QPinchGesture;
 
@@ -40,6 +41,8 @@ public:
     //返回当前图片img
     const QImage image();
     void openFilterImage(QImage img);
+    //清除框选区域
+    void clearSelection();
 public slots:
     //适应窗口大小
     void fitWindow();
@@ -61,7 +64,12 @@ protected:
 signals:
     void scaled(qreal perc);
     void showScaleLabel();
+    //按住Ctrl拖动框选识别区域，rect为旋转前的原图坐标，为空表示取消框选
+    void regionSelected(const QRect &rect);
 private:
+    //框选区域(当前显示图片的场景坐标)转换为旋转前的原图坐标
+    QRect sourceRect(const QRectF &sceneRect) const;
+
     QString m_currentPath;//当前图片路径
     QGraphicsPixmapItem *m_pixmapItem{nullptr};//当前图像的item
     bool m_isFitImage = false;//是否适应图片
@@ -71,6 +79,9 @@ private:
     QImage *m_currentImage{nullptr};//当前原始图像
     QImage m_FilterImage{nullptr};//当前处理的图像
     QImage m_lightContrastImage{nullptr};//亮度曝光度图像
+    QGraphicsRectItem *m_selectionItem{nullptr};//框选区域，作为图片的子项随图片清除
+    QPointF m_selectionOrigin;//框选起点，图片坐标
+    bool m_isSelecting = false;//是否正在框选
 
 };
 
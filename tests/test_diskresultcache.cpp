@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "engine/diskresultcache.h"
+
+static constexpr quint64 kModelId = 0x1234;
+
+TEST(DiskResultCache, roundTrip)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.filePath("results.cache");
+
+    {
+        DiskResultCache cache(path, 64 * 1024, kModelId);
+        ASSERT_TRUE(cache.isEnabled());
+        cache.insert("key-1", QString::fromUtf8("第一行\nsecond line"));
+        cache.insert("key-2", "value-2");
+        cache.insert("key-1", "value-1");
+
+        QString result;
+        EXPECT_TRUE(cache.find("key-1", &result));
+        EXPECT_EQ(result, "value-1");
+        EXPECT_FALSE(cache.find("missing", &result));
+    }
+
+    //重新打开后从文件建立索引，同一个键以最后写入的为准
+    {
+        DiskResultCache cache(path, 64 * 1024, kModelId);
+        QString result;
+        EXPECT_TRUE(cache.find("key-1", &result));
+        EXPECT_EQ(result, "value-1");
+        EXPECT_TRUE(cache.find("key-2", &result));
+        EXPECT_EQ(result, "value-2");
+    }
+
+    //模型变化后旧结果作废
+    {
+        DiskResultCache cache(path, 64 * 1024, kModelId + 1);
+        QString result;
+        EXPECT_FALSE(cache.find("key-1", &result));
+    }
+}
+
+//写入不完整的记录在打开时截掉，之前的记录仍然有效
+TEST(DiskResultCache, dropsTruncatedRecord)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.filePath("results.cache");
+
+    qint64 validSize = 0;
+    {
+        DiskResultCache cache(path, 64 * 1024, kModelId);
+        cache.insert("key", "value");
+        validSize = cache.size();
+    }
+    {
+        QFile file(path);
+        ASSERT_TRUE(file.open(QIODevice::Append));
+        file.write(QByteArray(10, 'x'));
+    }
+
+    DiskResultCache cache(path, 64 * 1024, kModelId);
+    EXPECT_EQ(cache.size(), validSize);
+    QString result;
+    EXPECT_TRUE(cache.find("key", &result));
+    EXPECT_EQ(result, "value");
+}
+
+//超过大小上限时保留较新的记录
+TEST(DiskResultCache, compaction)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.filePath("results.cache");
+    const qint64 maxBytes = 4096;
+    const QString value(100, 'v');
+
+    DiskResultCache cache(path, maxBytes, kModelId);
+    const int count = 200;
+    for (int i = 0; i < count; ++i) {
+        cache.insert(QString("key-%1").arg(i), value);
+        EXPECT_LE(cache.size(), maxBytes);
+    }
+    EXPECT_LE(QFile(path).size(), maxBytes);
+
+    QString result;
+    EXPECT_TRUE(cache.find(QString("key-%1").arg(count - 1), &result));
+    EXPECT_EQ(result, value);
+    EXPECT_FALSE(cache.find("key-0", &result));
+
+    //压缩后的文件重新打开仍然可用
+    DiskResultCache reopened(path, maxBytes, kModelId);
+    EXPECT_TRUE(reopened.find(QString("key-%1").arg(count - 1), &result));
+}
+
+TEST(DiskResultCache, disabled)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    DiskResultCache cache(dir.filePath("results.cache"), 0, kModelId);
+    EXPECT_FALSE(cache.isEnabled());
+    cache.insert("key", "value");
+    QString result;
+    EXPECT_FALSE(cache.find("key", &result));
+}
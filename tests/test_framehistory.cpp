@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <QPainter>
+
+#include "engine/framehistory.h"
+
+//从左到右变暗的画面，dHash的每一位都确定
+static QImage gradientFrame(bool reversed = false)
+{
+    QImage image(640, 480, QImage::Format_RGB32);
+    for (int y = 0; y < image.height(); ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < image.width(); ++x) {
+            const int gray = 255 - x * 255 / (image.width() - 1);
+            const int value = reversed ? 255 - gray : gray;
+            line[x] = qRgb(value, value, value);
+        }
+    }
+    return image;
+}
+
+static OcrTextBox makeBox(const QRect &rect, const QString &text)
+{
+    OcrTextBox box;
+    box.polygon = QPolygonF(QRectF(rect));
+    box.text = text;
+    return box;
+}
+
+TEST(FrameHistory, unchanged)
+{
+    FrameHistory history(4);
+    const QImage frame = gradientFrame();
+    history.insert(FrameHistory::signature(frame), "zh-Hans_en", "text", QList<OcrTextBox>());
+
+    QString text;
+    QList<OcrTextBox> boxes;
+    QRect changed;
+    EXPECT_EQ(history.match(FrameHistory::signature(frame.copy()), "zh-Hans_en", &text, &boxes, &changed),
+              FrameHistory::Unchanged);
+    EXPECT_EQ(text, "text");
+
+    //语言不同的结果不能复用
+    EXPECT_EQ(history.match(FrameHistory::signature(frame), "en", &text, &boxes, &changed), FrameHistory::NoMatch);
+    //完全不同的画面
+    EXPECT_EQ(history.match(FrameHistory::signature(gradientFrame(true)), "zh-Hans_en", &text, &boxes, &changed),
+              FrameHistory::NoMatch);
+}
+
+TEST(FrameHistory, regionChanged)
+{
+    FrameHistory history(4);
+    const QImage frame = gradientFrame();
+    QList<OcrTextBox> previous;
+    previous << makeBox(QRect(0, 0, 100, 20), "keep") << makeBox(QRect(380, 300, 100, 20), "old");
+    history.insert(FrameHistory::signature(frame), "zh-Hans_en", "keep\nold", previous);
+
+    QImage edited = frame.copy();
+    QPainter painter(&edited);
+    painter.fillRect(QRect(400, 304, 32, 16), Qt::black);
+    painter.end();
+
+    QString text;
+    QList<OcrTextBox> boxes;
+    QRect changed;
+    ASSERT_EQ(history.match(FrameHistory::signature(edited), "zh-Hans_en", &text, &boxes, &changed),
+              FrameHistory::RegionChanged);
+    EXPECT_EQ(text, "keep\nold");
+    EXPECT_EQ(boxes.size(), 2);
+    //变化区域扩展到覆盖与之相交的文本框
+    EXPECT_TRUE(changed.contains(QRect(400, 304, 32, 16)));
+    EXPECT_TRUE(changed.contains(QRect(380, 300, 100, 20)));
+    EXPECT_FALSE(changed.intersects(QRect(0, 0, 100, 20)));
+
+    const QList<OcrTextBox> spliced = FrameHistory::splice(boxes, changed, {makeBox(QRect(380, 300, 100, 20), "new")});
+    ASSERT_EQ(spliced.size(), 2);
+    EXPECT_EQ(spliced.at(0).text, "keep");
+    EXPECT_EQ(spliced.at(1).text, "new");
+}
+
+//超出容量时淘汰最早的画面
+TEST(FrameHistory, capacity)
+{
+    FrameHistory history(1);
+    history.insert(FrameHistory::signature(gradientFrame()), "zh-Hans_en", "first", QList<OcrTextBox>());
+    history.insert(FrameHistory::signature(gradientFrame(true)), "zh-Hans_en", "second", QList<OcrTextBox>());
+
+    QString text;
+    QList<OcrTextBox> boxes;
+    QRect changed;
+    EXPECT_EQ(history.match(FrameHistory::signature(gradientFrame()), "zh-Hans_en", &text, &boxes, &changed),
+              FrameHistory::NoMatch);
+    EXPECT_EQ(history.match(FrameHistory::signature(gradientFrame(true)), "zh-Hans_en", &text, &boxes, &changed),
+              FrameHistory::Unchanged);
+    EXPECT_EQ(text, "second");
+}
+
+//一个小数点大小的变化也要被发现，不能当作画面没有变化
+TEST(FrameHistory, smallGlyphChange)
+{
+    FrameHistory history(4);
+    const QImage frame = gradientFrame();
+    history.insert(FrameHistory::signature(frame), "zh-Hans_en", "3.14", QList<OcrTextBox>());
+
+    QImage edited = frame.copy();
+    QPainter painter(&edited);
+    painter.fillRect(QRect(300, 200, 2, 2), Qt::black);
+    painter.end();
+
+    QString text;
+    QList<OcrTextBox> boxes;
+    QRect changed;
+    ASSERT_EQ(history.match(FrameHistory::signature(edited), "zh-Hans_en", &text, &boxes, &changed),
+              FrameHistory::RegionChanged);
+    EXPECT_TRUE(changed.contains(QRect(300, 200, 2, 2)));
+}
@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <QImage>
+#include <QByteArray>
+
+#include <cstring>
+
+#include "engine/imagehash.h"
+
+//摘要会写入磁盘缓存，算法变化后旧缓存全部失效，这里固定几个已知值(小端平台)
+TEST(ImageHash, knownValues)
+{
+    QImage image(4, 4, QImage::Format_Grayscale8);
+    image.fill(0x7f);
+    EXPECT_EQ(ImageHash::digest(image), 0x21c56292e942a133ULL);
+
+    const QByteArray text("deepin-ocr");
+    EXPECT_EQ(ImageHash::hash(text.constData(), text.size()), 0x20944c2e0e95df75ULL);
+
+    QByteArray bytes(100, '\0');
+    for (int i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<char>(i);
+    }
+    EXPECT_EQ(ImageHash::hash(bytes.constData(), bytes.size()), 0xf345880713d697dfULL);
+}
+
+//行尾对齐填充不参与计算
+TEST(ImageHash, ignoresStridePadding)
+{
+    QImage image(10, 10, QImage::Format_Grayscale8);
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            image.scanLine(y)[x] = static_cast<uchar>(x * 10 + y);
+        }
+    }
+
+    const int stride = 16;
+    QByteArray buffer(stride * image.height(), static_cast<char>(0xab));
+    for (int y = 0; y < image.height(); ++y) {
+        memcpy(buffer.data() + y * stride, image.constScanLine(y), static_cast<size_t>(image.width()));
+    }
+    const QImage padded(reinterpret_cast<const uchar *>(buffer.constData()), image.width(), image.height(), stride,
+                        QImage::Format_Grayscale8);
+
+    EXPECT_EQ(ImageHash::digest(image), ImageHash::digest(padded));
+    EXPECT_EQ(ImageHash::digest(image), ImageHash::digest(image.copy()));
+}
+
+TEST(ImageHash, sensitiveToContent)
+{
+    QImage image(32, 32, QImage::Format_RGB32);
+    image.fill(Qt::white);
+    const quint64 digest = ImageHash::digest(image);
+
+    QImage changed = image.copy();
+    changed.setPixel(31, 31, qRgb(254, 255, 255));
+    EXPECT_NE(digest, ImageHash::digest(changed));
+
+    //字节相同但尺寸不同
+    QImage reshaped(64, 16, QImage::Format_RGB32);
+    reshaped.fill(Qt::white);
+    EXPECT_NE(digest, ImageHash::digest(reshaped));
+
+    EXPECT_EQ(ImageHash::digest(QImage()), 0u);
+}
@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <QElapsedTimer>
+#include <QImage>
+#include <QDebug>
+#include <QRandomGenerator>
+
+#include "engine/imageingest.h"
+
+static QImage randomImage(int width, int height, QImage::Format format)
+{
+    QImage image(width, height, format);
+    QRandomGenerator generator(width * 131 + height);
+    for (int y = 0; y < image.height(); ++y) {
+        quint32 *line = reinterpret_cast<quint32 *>(image.scanLine(y));
+        for (int x = 0; x < image.width(); ++x) {
+            line[x] = generator.generate() | (format == QImage::Format_RGB32 ? 0xff000000u : 0u);
+        }
+    }
+    return image;
+}
+
+//SIMD实现与逐像素实现的结果逐字节相同，覆盖不足一次向量宽度的行尾
+TEST(ImageIngest, simdMatchesScalar)
+{
+    for (QImage::Format format : {QImage::Format_RGB32, QImage::Format_ARGB32}) {
+        for (int width = 1; width <= 70; ++width) {
+            const QImage image = randomImage(width, 3, format);
+            const QImage best = ImageIngest::toDriverFormat(image, nullptr, ImageIngest::BestKernel);
+            const QImage scalar = ImageIngest::toDriverFormat(image, nullptr, ImageIngest::ScalarKernel);
+            ASSERT_EQ(best.format(), ImageIngest::DriverFormat);
+            ASSERT_EQ(best, scalar) << "width " << width << " kernel " << ImageIngest::bestKernelName();
+            //Qt转换带alpha的格式时会先预乘，只对不透明格式比较
+            if (format == QImage::Format_RGB32) {
+                ASSERT_EQ(scalar, image.convertToFormat(ImageIngest::DriverFormat)) << "width " << width;
+            }
+        }
+    }
+}
+
+TEST(ImageIngest, driverFormatIsShared)
+{
+    const QImage image = randomImage(64, 8, QImage::Format_RGB32).convertToFormat(ImageIngest::DriverFormat);
+    qint64 bytesCopied = 0;
+    const QImage result = ImageIngest::toDriverFormat(image, &bytesCopied);
+    EXPECT_EQ(result.constBits(), image.constBits());
+    EXPECT_EQ(bytesCopied, 0);
+}
+
+//4K画面转换耗时对比，结果记录在测试报告中；只要求SIMD实现不慢于逐像素实现
+TEST(ImageIngest, benchmarkKernels)
+{
+    const QImage image = randomImage(3840, 2160, QImage::Format_ARGB32);
+    const int rounds = 10;
+    qint64 elapsed[2] = {0, 0};
+    const ImageIngest::Kernel kernels[2] = {ImageIngest::ScalarKernel, ImageIngest::BestKernel};
+    for (int i = 0; i < 2; ++i) {
+        //预热一次，排除首次分配内存的开销
+        ImageIngest::toDriverFormat(image, nullptr, kernels[i]);
+        QElapsedTimer timer;
+        timer.start();
+        for (int round = 0; round < rounds; ++round) {
+            ImageIngest::toDriverFormat(image, nullptr, kernels[i]);
+        }
+        elapsed[i] = timer.nsecsElapsed() / rounds;
+    }
+    qInfo() << "ImageIngest 3840x2160 ARGB32 -> RGB888, scalar:" << elapsed[0] / 1000 << "us"
+            << ImageIngest::bestKernelName() << ":" << elapsed[1] / 1000 << "us";
+    RecordProperty("scalar_us", static_cast<int>(elapsed[0] / 1000));
+    RecordProperty("best_us", static_cast<int>(elapsed[1] / 1000));
+    EXPECT_LE(elapsed[1], elapsed[0] * 11 / 10);
+}
@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <QImage>
+
+#include "service/rawimage.h"
+
+static QImage testImage()
+{
+    QImage image(53, 29, QImage::Format_RGB32);
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            image.setPixel(x, y, qRgb(x * 4, y * 8, (x ^ y) & 0xff));
+        }
+    }
+    return image;
+}
+
+//每种编码编码后都能解码出相同的图片
+TEST(RawImage, roundTripEachEncoding)
+{
+    const QImage image = testImage();
+    for (int encoding : RawImage::supportedEncodings()) {
+        RawImage::Encoding used = static_cast<RawImage::Encoding>(encoding);
+        const QByteArray data = RawImage::encode(image, &used);
+        EXPECT_EQ(used, encoding);
+
+        QString error;
+        const QImage decoded = RawImage::decode(data, image.width(), image.height(), image.bytesPerLine(), image.format(), used, &error);
+        ASSERT_FALSE(decoded.isNull()) << "encoding " << encoding << ": " << error.toStdString();
+        EXPECT_EQ(decoded.convertToFormat(image.format()), image) << "encoding " << encoding;
+    }
+}
+
+TEST(RawImage, chooseEncoding)
+{
+    const QList<int> all = RawImage::supportedEncodings();
+    EXPECT_EQ(RawImage::chooseEncoding(1024, all), RawImage::Raw);
+    EXPECT_EQ(RawImage::chooseEncoding(64LL * 1024 * 1024, all), RawImage::Lz4);
+    EXPECT_EQ(RawImage::chooseEncoding(64LL * 1024 * 1024, {RawImage::Raw, RawImage::Zlib, RawImage::Png}), RawImage::Zlib);
+    EXPECT_EQ(RawImage::chooseEncoding(1024, {RawImage::Png}), RawImage::Png);
+}
+
+TEST(RawImage, rejectsBadStride)
+{
+    const QImage image = testImage();
+    RawImage::Encoding encoding = RawImage::Raw;
+    const QByteArray data = RawImage::encode(image, &encoding);
+
+    QString error;
+    //行字节数小于一行像素
+    EXPECT_TRUE(RawImage::decode(data, image.width(), image.height(), image.width() * 4 - 1, image.format(), RawImage::Raw, &error).isNull());
+    EXPECT_FALSE(error.isEmpty());
+    //行字节数与数据长度不符
+    error.clear();
+    EXPECT_TRUE(RawImage::decode(data, image.width(), image.height(), image.bytesPerLine() * 2, image.format(), RawImage::Raw, &error).isNull());
+    EXPECT_FALSE(error.isEmpty());
+    //行字节数为负
+    error.clear();
+    EXPECT_TRUE(RawImage::decode(data, image.width(), image.height(), -image.bytesPerLine(), image.format(), RawImage::Raw, &error).isNull());
+    EXPECT_FALSE(error.isEmpty());
+}
+
+TEST(RawImage, rejectsBadData)
+{
+    const QImage image = testImage();
+    QString error;
+    //压缩数据损坏
+    EXPECT_TRUE(RawImage::decode(QByteArray(64, 'x'), image.width(), image.height(), image.bytesPerLine(), image.format(), RawImage::Lz4, &error).isNull());
+    EXPECT_FALSE(error.isEmpty());
+    error.clear();
+    EXPECT_TRUE(RawImage::decode(QByteArray(64, 'x'), image.width(), image.height(), image.bytesPerLine(), image.format(), RawImage::Zlib, &error).isNull());
+    EXPECT_FALSE(error.isEmpty());
+    //未知的编码
+    error.clear();
+    EXPECT_TRUE(RawImage::decode(QByteArray(64, 'x'), image.width(), image.height(), image.bytesPerLine(), image.format(), 42, &error).isNull());
+    EXPECT_FALSE(error.isEmpty());
+}
@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <QImage>
+
+#include "service/sharedimage.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static QImage testImage()
+{
+    QImage image(37, 21, QImage::Format_ARGB32);
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            image.setPixel(x, y, qRgba(x * 6, y * 12, (x + y) * 4, 255));
+        }
+    }
+    return image;
+}
+
+//已封印的memfd直接映射，图片数据指向映射而不是副本
+TEST(SharedImage, sealedMemfd)
+{
+    const QImage image = testImage();
+    const int fd = SharedImage::toFd(image);
+    ASSERT_GE(fd, 0);
+    const int seals = fcntl(fd, F_GET_SEALS);
+    EXPECT_EQ(seals & (F_SEAL_WRITE | F_SEAL_SHRINK), F_SEAL_WRITE | F_SEAL_SHRINK);
+
+    QString error;
+    const QImage shared = SharedImage::fromFd(fd, image.width(), image.height(), image.bytesPerLine(), image.format(), &error);
+    close(fd);
+    ASSERT_FALSE(shared.isNull()) << error.toStdString();
+    EXPECT_EQ(shared, image);
+    EXPECT_NE(shared.constBits(), image.constBits());
+}
+
+//未封印的描述符读取副本，之后修改文件不影响图片
+TEST(SharedImage, unsealedMemfd)
+{
+    const QImage image = testImage();
+    const int fd = memfd_create("deepin-ocr-test", MFD_CLOEXEC);
+    ASSERT_GE(fd, 0);
+    const qint64 length = image.sizeInBytes();
+    ASSERT_EQ(write(fd, image.constBits(), static_cast<size_t>(length)), length);
+
+    QString error;
+    const QImage copied = SharedImage::fromFd(fd, image.width(), image.height(), image.bytesPerLine(), image.format(), &error);
+    ASSERT_FALSE(copied.isNull()) << error.toStdString();
+    EXPECT_EQ(copied, image);
+
+    const QByteArray zeros(static_cast<int>(length), '\0');
+    ASSERT_EQ(pwrite(fd, zeros.constData(), static_cast<size_t>(length), 0), length);
+    close(fd);
+    EXPECT_EQ(copied, image);
+}
+
+TEST(SharedImage, rejectsBadArguments)
+{
+    const QImage image = testImage();
+    const int fd = SharedImage::toFd(image);
+    ASSERT_GE(fd, 0);
+
+    QString error;
+    //行字节数小于一行像素
+    EXPECT_TRUE(SharedImage::fromFd(fd, image.width(), image.height(), image.width() * 4 - 1, image.format(), &error).isNull());
+    EXPECT_FALSE(error.isEmpty());
+    //文件小于图片数据
+    error.clear();
+    EXPECT_TRUE(SharedImage::fromFd(fd, image.width(), image.height() + 1, image.bytesPerLine(), image.format(), &error).isNull());
+    EXPECT_FALSE(error.isEmpty());
+    //无效的格式
+    error.clear();
+    EXPECT_TRUE(SharedImage::fromFd(fd, image.width(), image.height(), image.bytesPerLine(), QImage::Format_Invalid, &error).isNull());
+    EXPECT_FALSE(error.isEmpty());
+    close(fd);
+}
@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "engine/tilelayout.h"
+
+static OcrTextBox makeBox(const QRectF &rect, const QString &text, float confidence = -1)
+{
+    OcrTextBox box;
+    box.polygon = QPolygonF(rect);
+    box.text = text;
+    box.confidence = confidence;
+    return box;
+}
+
+TEST(TileLayout, splitSmallImage)
+{
+    const QList<TileLayout::Tile> tiles = TileLayout::split(QSize(500, 300), 1000, 100);
+    ASSERT_EQ(tiles.size(), 1);
+    EXPECT_EQ(tiles.first().rect, QRect(0, 0, 500, 300));
+    EXPECT_EQ(tiles.first().core, QRect(0, 0, 500, 300));
+}
+
+//各分块的core互不重叠且拼接后覆盖整图，分块之间至少重叠overlap
+TEST(TileLayout, splitCoresCoverImage)
+{
+    const QSize size(2500, 1800);
+    const int overlap = 200;
+    const QList<TileLayout::Tile> tiles = TileLayout::split(size, 1000, overlap);
+    ASSERT_GT(tiles.size(), 1);
+
+    qint64 coreArea = 0;
+    for (int i = 0; i < tiles.size(); ++i) {
+        const TileLayout::Tile &tile = tiles.at(i);
+        EXPECT_TRUE(QRect(QPoint(0, 0), size).contains(tile.rect));
+        EXPECT_TRUE(tile.rect.contains(tile.core));
+        coreArea += static_cast<qint64>(tile.core.width()) * tile.core.height();
+        for (int j = i + 1; j < tiles.size(); ++j) {
+            EXPECT_FALSE(tile.core.intersects(tiles.at(j).core));
+            const QRect shared = tile.rect.intersected(tiles.at(j).rect);
+            if (tile.rect.top() == tiles.at(j).rect.top() && shared.isValid()) {
+                EXPECT_GE(shared.width(), overlap);
+            }
+        }
+    }
+    EXPECT_EQ(coreArea, static_cast<qint64>(size.width()) * size.height());
+}
+
+//横跨分块边界的一行文字在两侧分块中都被识别，合并后字符不重复
+TEST(TileLayout, mergeLineCrossingSeam)
+{
+    const QList<TileLayout::Tile> tiles = TileLayout::split(QSize(2000, 100), QSize(1200, 100), 400);
+    ASSERT_EQ(tiles.size(), 2);
+    ASSERT_EQ(tiles.at(0).core.right() + 1, 1000);
+    ASSERT_EQ(tiles.at(1).rect.left(), 800);
+
+    //每个字符宽20像素，原图中位于x=900到1100
+    std::vector<QList<OcrTextBox>> tileBoxes(2);
+    tileBoxes[0] << makeBox(QRectF(900, 40, 200, 20), "ABCDEFGHIJ", 0.9f)
+                 << makeBox(QRectF(100, 40, 200, 20), "left");
+    tileBoxes[1] << makeBox(QRectF(100, 40, 200, 20), "ABCDEFGHIJ", 0.8f)
+                 << makeBox(QRectF(900, 40, 200, 20), "right");
+
+    const QList<OcrTextBox> merged = TileLayout::merge(tiles, tileBoxes);
+    ASSERT_EQ(merged.size(), 3);
+    EXPECT_EQ(TileLayout::toText(merged), "left ABCDEFGHIJ right");
+
+    for (const OcrTextBox &box : merged) {
+        if (box.text == "ABCDEFGHIJ") {
+            EXPECT_EQ(box.polygon.boundingRect(), QRectF(900, 40, 200, 20));
+            EXPECT_FLOAT_EQ(box.confidence, 0.8f);
+        }
+    }
+}
+
+//完全位于重叠区域的文本框只由所属分块保留
+TEST(TileLayout, mergeDropsOverlapCopy)
+{
+    const QList<TileLayout::Tile> tiles = TileLayout::split(QSize(2000, 100), QSize(1200, 100), 400);
+    ASSERT_EQ(tiles.size(), 2);
+
+    std::vector<QList<OcrTextBox>> tileBoxes(2);
+    tileBoxes[0] << makeBox(QRectF(820, 40, 60, 20), "dup");
+    tileBoxes[1] << makeBox(QRectF(20, 40, 60, 20), "dup");
+
+    const QList<OcrTextBox> merged = TileLayout::merge(tiles, tileBoxes);
+    ASSERT_EQ(merged.size(), 1);
+    EXPECT_EQ(merged.first().text, "dup");
+    EXPECT_EQ(merged.first().polygon.boundingRect(), QRectF(820, 40, 60, 20));
+}
+
+TEST(TileLayout, toTextReadingOrder)
+{
+    QList<OcrTextBox> boxes;
+    boxes << makeBox(QRectF(0, 50, 80, 20), "next")
+          << makeBox(QRectF(100, 2, 80, 20), "world")
+          << makeBox(QRectF(0, 0, 80, 20), "hello")
+          << makeBox(QRectF(0, 100, 80, 20), "");
+    EXPECT_EQ(TileLayout::toText(boxes), "hello world\nnext");
+    EXPECT_TRUE(TileLayout::toText(QList<OcrTextBox>()).isEmpty());
+}
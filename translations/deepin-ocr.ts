@@ -23,6 +23,11 @@
         <source>English</source>
         <translation type="unfinished"></translation>
     </message>
+    <message>
+        <location filename="../src/mainwidget.cpp" line="184"/>
+        <source>Auto detect</source>
+        <translation type="unfinished"></translation>
+    </message>
     <message>
         <location filename="../src/mainwidget.cpp" line="184"/>
         <source>Traditional Chinese</source>
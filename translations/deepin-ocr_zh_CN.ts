@@ -23,6 +23,11 @@
         <source>English</source>
         <translation>英文</translation>
     </message>
+    <message>
+        <location filename="../src/mainwidget.cpp" line="184"/>
+        <source>Auto detect</source>
+        <translation>自动检测</translation>
+    </message>
     <message>
         <location filename="../src/mainwidget.cpp" line="184"/>
         <source>Traditional Chinese</source>